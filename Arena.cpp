@@ -0,0 +1,73 @@
+/*
+ * Arena.cpp
+ *
+ *  Created on: 2026-10-19 05:46
+ */
+
+#include <new>
+#include <cstdlib>
+
+#include "Arena.h"
+
+using namespace std;
+
+Arena::~Arena(void)
+{
+    for (uint8_t *p : blocks) {
+        free(p);
+    }
+}
+
+void *Arena::alloc(size_t bytes)
+{
+    bytes = (bytes + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    // move on to the next block that fits, allocating one if needed
+    while (block < blocks.size() && used + bytes > sizes[block]) {
+        block++;
+        used = 0;
+    }
+
+    if (block == blocks.size()) {
+        size_t size = (bytes > ARENA_BLOCK_SIZE) ? bytes : ARENA_BLOCK_SIZE;
+        uint8_t *p = (uint8_t *)aligned_alloc(ARENA_ALIGN, size);
+
+        if (!p) {
+            throw bad_alloc();
+        }
+
+        blocks.push_back(p);
+        sizes.push_back(size);
+        used = 0;
+    }
+
+    void *p = blocks[block] + used;
+
+    used += bytes;
+
+    return p;
+}
+
+Arena::Mark Arena::mark(void) const
+{
+    return { block, used };
+}
+
+void Arena::release(const Mark &m)
+{
+    block = m.block;
+    used = m.used;
+}
+
+void Arena::reset(void)
+{
+    block = 0;
+    used = 0;
+}
+
+Arena &Arena::local(void)
+{
+    static thread_local Arena arena;
+
+    return arena;
+}
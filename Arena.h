@@ -0,0 +1,70 @@
+/*
+ * Arena.h
+ *
+ *  Created on: 2026-10-19 05:46
+ */
+
+#ifndef __ARENA__
+#define __ARENA__
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#define ARENA_ALIGN       64
+#define ARENA_BLOCK_SIZE  (256 * 1024)
+
+// bump allocator for solver scratch, memory is handed out uninitialized
+// and reused after release(), blocks are only freed with the arena
+class Arena
+{
+public:
+    struct Mark {
+        size_t block;
+        size_t used;
+    };
+
+private:
+    std::vector<uint8_t *> blocks;
+    std::vector<size_t> sizes;
+    size_t block = 0;
+    size_t used = 0;
+
+public:
+    Arena(void) = default;
+    ~Arena(void);
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *alloc(size_t bytes);
+
+    template <typename T>
+    T *alloc(size_t count)
+    {
+        static_assert(alignof(T) <= ARENA_ALIGN, "over-aligned type");
+
+        return (T *)alloc(sizeof(T) * count);
+    }
+
+    Mark mark(void) const;
+    void release(const Mark &m);
+    void reset(void);
+
+    // one arena per thread, created on first use
+    static Arena &local(void);
+};
+
+// returns everything allocated in the scope to the arena
+class ArenaScope
+{
+private:
+    Arena &arena;
+    Arena::Mark m;
+
+public:
+    ArenaScope(Arena &arena) : arena(arena), m(arena.mark()) {}
+    ~ArenaScope(void) { arena.release(m); }
+};
+
+#endif // __ARENA__
@@ -0,0 +1,130 @@
+/*
+ * AsyncSolver.cpp
+ *
+ *  Created on: 2026-10-19 05:43
+ */
+
+#include <cstring>
+
+#include "Arena.h"
+#include "AsyncSolver.h"
+
+using namespace std;
+
+AsyncSolver::AsyncSolver(int method, int threads, size_t capacity, int frac)
+    : method(method), frac(frac), stop(false), requests(capacity), results(capacity)
+{
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(&AsyncSolver::worker, this);
+    }
+}
+
+AsyncSolver::~AsyncSolver(void)
+{
+    stop.store(true, memory_order_release);
+
+    for (thread &t : workers) {
+        t.join();
+    }
+}
+
+// the workers group requests by size, anything outside 1..6 would index
+// past their pending groups and is refused here like a full ring
+bool AsyncSolver::submit(const int64_t i64EqualCoeff[7][7], int iParaNum, uint64_t tag)
+{
+    if (iParaNum < 1 || iParaNum > 6) {
+        return false;
+    }
+
+    SolveRequest req;
+
+    req.tag = tag;
+    req.iParaNum = iParaNum;
+    memcpy(req.i64EqualCoeff, i64EqualCoeff, sizeof(req.i64EqualCoeff));
+
+    return requests.push(req);
+}
+
+bool AsyncSolver::poll(SolveResult &res)
+{
+    return results.pop(res);
+}
+
+void AsyncSolver::solve_batch(BatchSolver *batch, SolveRequest *req, int num)
+{
+    int n = req[0].iParaNum;
+
+    for (int l = 0; l < num; l++) {
+        batch->load_data(l, req[l].i64EqualCoeff, n);
+    }
+
+    if (method == BATCH_DFA) {
+        batch->method_dfa(n);
+    } else {
+        batch->method_gem(n);
+    }
+
+    for (int l = 0; l < num; l++) {
+        SolveResult res;
+
+        res.tag = req[l].tag;
+
+        if (method == BATCH_DFA) {
+            res.status = batch->save_data(l, res.dAffinePara, n, frac);
+        } else {
+            res.status = batch->save_data_gem(l, res.dAffinePara, n);
+        }
+
+        // results are only dropped on shutdown, otherwise the worker waits for the consumer
+        while (!results.push(res) && !stop.load(memory_order_relaxed)) {
+            this_thread::yield();
+        }
+    }
+}
+
+void AsyncSolver::worker(void)
+{
+    BatchSolver *batch = new BatchSolver();
+    SolveRequest (*pend)[BATCH_LANES] = Arena::local().alloc<SolveRequest[BATCH_LANES]>(7);
+    int num[7] = { 0 };
+    int idle = 0;
+
+    while (true) {
+        SolveRequest req;
+        bool got = requests.pop(req);
+
+        if (got) {
+            int n = req.iParaNum;
+
+            // group by size, a full group goes out right away
+            pend[n][num[n]++] = req;
+            if (num[n] == BATCH_LANES) {
+                solve_batch(batch, pend[n], num[n]);
+                num[n] = 0;
+            }
+
+            idle = 0;
+            continue;
+        }
+
+        // ring drained, flush the partial groups
+        for (int n = 1; n < 7; n++) {
+            if (num[n]) {
+                solve_batch(batch, pend[n], num[n]);
+                num[n] = 0;
+            }
+        }
+
+        if (stop.load(memory_order_acquire)) {
+            break;
+        }
+
+        if (++idle < 64) {
+            this_thread::yield();
+        } else {
+            this_thread::sleep_for(chrono::microseconds(50));
+        }
+    }
+
+    delete(batch);
+}
@@ -0,0 +1,55 @@
+/*
+ * AsyncSolver.h
+ *
+ *  Created on: 2026-10-19 05:43
+ */
+
+#ifndef __ASYNC_SOLVER__
+#define __ASYNC_SOLVER__
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "SolveRing.h"
+#include "BatchSolver.h"
+
+struct SolveRequest {
+    uint64_t tag;
+    int iParaNum;
+    int64_t i64EqualCoeff[7][7];
+};
+
+struct SolveResult {
+    uint64_t tag;
+    int status;
+    double dAffinePara[6];
+};
+
+// producers submit systems into a lock-free ring without blocking, worker
+// threads drain it in BATCH_LANES sized groups through BatchSolver and post
+// the results into a completion ring; submit() fails when the ring is full
+// or the size is outside 1..6
+class AsyncSolver
+{
+private:
+    int method;
+    int frac;
+    std::atomic<bool> stop;
+
+    SolveRing<SolveRequest> requests;
+    SolveRing<SolveResult> results;
+    std::vector<std::thread> workers;
+
+    void worker(void);
+    void solve_batch(BatchSolver *batch, SolveRequest *req, int num);
+
+public:
+    AsyncSolver(int method, int threads, size_t capacity, int frac = 8);
+    ~AsyncSolver(void);
+
+    bool submit(const int64_t i64EqualCoeff[7][7], int iParaNum, uint64_t tag);
+    bool poll(SolveResult &res);
+};
+
+#endif // __ASYNC_SOLVER__
@@ -0,0 +1,438 @@
+/*
+ * BatchSolver.cpp
+ *
+ *  Created on: 2026-10-19 05:37
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "Arena.h"
+#include "GradAccum.h"
+#include "BatchSolver.h"
+#include "EquationSolverInline.h"
+
+using namespace std;
+
+// file-local ISA clones, each inlines the private kernel it forwards to
+struct BatchSolverKernel {
+    SOLVER_KERNEL static void method_gem(BatchSolver *s, int n)
+    {
+        s->method_gem_kernel(n);
+    }
+
+    SOLVER_KERNEL static void method_dfa(BatchSolver *s, int n)
+    {
+        s->method_dfa_kernel(n);
+    }
+
+    SOLVER_KERNEL static void solve_gem_fused(BatchSolver *s, int count, const int64_t (*i64EqualCoeff)[7][7], int iParaNum, double (*dAffinePara)[6], int *iStatus)
+    {
+        s->solve_gem_fused_kernel(count, i64EqualCoeff, iParaNum, dAffinePara, iStatus);
+    }
+};
+
+#define COMP_DIV_BITS     64
+
+#define LANE_LOOP(l)      for (int l = 0; l < BATCH_LANES; l++)
+
+void BatchSolver::set_ridge(int64_t val)
+{
+    ridge = val;
+}
+
+void BatchSolver::load_data(int lane, const int64_t i64EqualCoeff[7][7], int iParaNum)
+{
+    for (int row = 0; row < iParaNum; row++) {
+        for (int i = 0; i < iParaNum + 1; i++) {
+            C[row][i][lane] = (double)ridge_add(i64EqualCoeff[row + 1][i], (i == row) ? ridge : 0);
+        }
+    }
+}
+
+void BatchSolver::load_grad(int lane, const int32_t *piResi, const int32_t *piGradX, const int32_t *piGradY,
+                            int stride, int width, int height, int iParaNum)
+{
+    int64_t sum[GRAD_SUM_NUM];
+
+    // no gradient model for this size, an all-zero lane fails as singular
+    if (!grad_accum(piResi, piGradX, piGradY, stride, width, height, iParaNum, sum)) {
+        for (int row = 0; row < 7; row++) {
+            for (int i = 0; i < 7; i++) {
+                C[row][i][lane] = 0;
+            }
+        }
+
+        return;
+    }
+
+    for (int row = 0; row < iParaNum; row++) {
+        for (int i = 0; i < iParaNum + 1; i++) {
+            int64_t v = (i < row) ? sum[grad_index(i, row, iParaNum)] : sum[grad_index(row, i, iParaNum)];
+
+            C[row][i][lane] = (double)ridge_add(v, (i == row) ? ridge : 0);
+        }
+    }
+}
+
+int BatchSolver::get_status(int lane) const
+{
+    return status[lane];
+}
+
+SOLVER_INLINE void BatchSolver::method_gem_kernel(int n)
+{
+    ArenaScope scope(Arena::local());
+    double (*T)[7][BATCH_LANES] = Arena::local().alloc<double[7][BATCH_LANES]>(7);
+
+    for (int p = 0; p < n; p++) {
+        for (int q = 0; q < n + 1; q++) {
+            LANE_LOOP(l) T[p][q][l] = C[p][q][l];
+        }
+    }
+
+    LANE_LOOP(l) status[l] = SOLVE_OK;
+
+    for (int k = 0; k < n; k++) {
+        int m[BATCH_LANES];
+        double t[BATCH_LANES];
+        double M[BATCH_LANES];
+
+        // find column max, first maximum wins as in pivot_mat
+        LANE_LOOP(l) {
+            m[l] = k;
+            t[l] = fabs(T[k][k][l]);
+        }
+
+        for (int i = k + 1; i < n; i++) {
+            LANE_LOOP(l) {
+                bool c = fabs(T[i][k][l]) > t[l];
+                t[l] = c ? fabs(T[i][k][l]) : t[l];
+                m[l] = c ? i : m[l];
+            }
+        }
+
+        // swap rows k and m with selects
+        for (int i = k + 1; i < n; i++) {
+            for (int j = 0; j < n + 1; j++) {
+                LANE_LOOP(l) {
+                    bool c = (m[l] == i);
+                    double a = T[k][j][l];
+                    double b = T[i][j][l];
+                    T[k][j][l] = c ? b : a;
+                    T[i][j][l] = c ? a : b;
+                }
+            }
+        }
+
+        // a failed lane keeps running on a dummy pivot
+        LANE_LOOP(l) {
+            bool z = (T[k][k][l] == 0.);
+            status[l] = z ? SOLVE_SINGULAR : status[l];
+            M[l] = z ? 1.0 : T[k][k][l];
+        }
+
+        // make T[i][k] zero
+        for (int i = k + 1; i < n; i++) {
+            double L[BATCH_LANES];
+
+            LANE_LOOP(l) L[l] = T[i][k][l];
+
+            for (int j = k; j < n + 1; j++) {
+                LANE_LOOP(l) T[i][j][l] = T[i][j][l] - (L[l] / M[l]) * T[k][j][l];
+            }
+        }
+
+        // make T[k][k] one
+        for (int j = k; j < n + 1; j++) {
+            LANE_LOOP(l) T[k][j][l] = T[k][j][l] / M[l];
+        }
+    }
+
+    for (int p = 0; p < n; p++) {
+        for (int q = 0; q < n + 1; q++) {
+            LANE_LOOP(l) C[p][q][l] = T[p][q][l];
+        }
+    }
+}
+
+void BatchSolver::method_gem(int n)
+{
+    BatchSolverKernel::method_gem(this, n);
+}
+
+SOLVER_INLINE void BatchSolver::method_dfa_kernel(int n)
+{
+    ArenaScope scope(Arena::local());
+    int64_t (*T)[7][BATCH_LANES] = Arena::local().alloc<int64_t[7][BATCH_LANES]>(7);
+
+    for (int p = 0; p < n; p++) {
+        for (int q = 0; q < n + 1; q++) {
+            LANE_LOOP(l) T[p][q][l] = (int64_t)C[p][q][l];
+        }
+    }
+
+    LANE_LOOP(l) status[l] = SOLVE_OK;
+
+    for (int k = 0; k < n; k++) {
+        int m[BATCH_LANES];
+        int64_t t[BATCH_LANES];
+        int64_t M[BATCH_LANES];
+
+        // find column max, first maximum wins as in pivot_mat
+        LANE_LOOP(l) {
+            m[l] = k;
+            t[l] = llabs(T[k][k][l]);
+        }
+
+        for (int i = k + 1; i < n; i++) {
+            LANE_LOOP(l) {
+                bool c = llabs(T[i][k][l]) > t[l];
+                t[l] = c ? llabs(T[i][k][l]) : t[l];
+                m[l] = c ? i : m[l];
+            }
+        }
+
+        // swap rows k and m with selects
+        for (int i = k + 1; i < n; i++) {
+            for (int j = 0; j < n + 1; j++) {
+                LANE_LOOP(l) {
+                    bool c = (m[l] == i);
+                    int64_t a = T[k][j][l];
+                    int64_t b = T[i][j][l];
+                    T[k][j][l] = c ? b : a;
+                    T[i][j][l] = c ? a : b;
+                }
+            }
+        }
+
+        // a failed lane keeps running on a dummy pivot
+        LANE_LOOP(l) {
+            bool z = (T[k][k][l] == 0);
+            status[l] = z ? SOLVE_SINGULAR : status[l];
+            M[l] = z ? 1 : T[k][k][l];
+        }
+
+        // make T[i][k] zero, wrapping like the scalar kernel
+        for (int i = 0; i < n; i++) {
+            if (i == k) {
+                continue;
+            }
+
+            int64_t L[BATCH_LANES];
+
+            LANE_LOOP(l) L[l] = T[i][k][l];
+
+            for (int j = 0; j < n + 1; j++) {
+                LANE_LOOP(l) T[i][j][l] = (int64_t)((uint64_t)M[l] * (uint64_t)T[i][j][l] -
+                                                    (uint64_t)L[l] * (uint64_t)T[k][j][l]);
+            }
+        }
+    }
+
+    for (int p = 0; p < n; p++) {
+        for (int q = 0; q < n + 1; q++) {
+            LANE_LOOP(l) C[p][q][l] = (double)T[p][q][l];
+        }
+    }
+}
+
+void BatchSolver::method_dfa(int n)
+{
+    BatchSolverKernel::method_dfa(this, n);
+}
+
+int BatchSolver::save_data_gem(int lane, double dAffinePara[6], int iParaNum)
+{
+    if (status[lane] != SOLVE_OK) {
+        for (int i = 0; i < iParaNum; i++) {
+            dAffinePara[i] = 0;
+        }
+
+        return status[lane];
+    }
+
+    dAffinePara[iParaNum - 1] = C[iParaNum - 1][iParaNum][lane] / C[iParaNum - 1][iParaNum - 1][lane];
+
+    for (int i = iParaNum - 2; i >= 0; i--) {
+        double temp = 0;
+
+        for (int j = i + 1; j < iParaNum; j++) {
+            temp += C[i][j][lane] * dAffinePara[j];
+        }
+
+        dAffinePara[i] = (C[i][iParaNum][lane] - temp) / C[i][i][lane];
+    }
+
+    return SOLVE_OK;
+}
+
+int BatchSolver::save_data(int lane, double dAffinePara[6], int iParaNum, int frac)
+{
+    if (status[lane] != SOLVE_OK) {
+        for (int i = 0; i < iParaNum; i++) {
+            dAffinePara[i] = 0;
+        }
+
+        return status[lane];
+    }
+
+    for (int i = 0; i < iParaNum; i++) {
+        int64_t dividend  = (int64_t)C[i][iParaNum][lane];
+        int64_t divisor   = (int64_t)C[i][i][lane];
+        int64_t divisor_f = divisor >> frac;
+        int64_t quotient = 0;
+
+        int64_t _D = dividend;
+        int     _F = frac;
+
+        uint8_t D_BITS = (_D == 0) ? 0 : (uint8_t)logb(_D);
+        uint8_t F_BITS = (_F == 0) ? 0 : (uint8_t)logb(_F);
+
+        int16_t DF_BITS = D_BITS + F_BITS;
+
+        if (DF_BITS >= COMP_DIV_BITS) {
+            divisor = divisor_f;
+        } else {
+            dividend = dividend << frac;
+        }
+
+        // a zero divisor behaves like a singular system
+        if (divisor == 0) {
+            for (int i = 0; i < iParaNum; i++) {
+                dAffinePara[i] = 0;
+            }
+
+            return SOLVE_SINGULAR;
+        }
+
+        quotient = dividend / divisor;
+
+        dAffinePara[i] = quotient / pow(2.0, frac);
+    }
+
+    return SOLVE_OK;
+}
+
+void BatchSolver::solve_gem(int count, const int64_t (*i64EqualCoeff)[7][7], int iParaNum,
+                            double (*dAffinePara)[6], int *iStatus)
+{
+    for (int base = 0; base < count; base += BATCH_LANES) {
+        int num = (count - base < BATCH_LANES) ? count - base : BATCH_LANES;
+
+        for (int l = 0; l < num; l++) {
+            load_data(l, i64EqualCoeff[base + l], iParaNum);
+        }
+
+        method_gem(iParaNum);
+
+        for (int l = 0; l < num; l++) {
+            iStatus[base + l] = save_data_gem(l, dAffinePara[base + l], iParaNum);
+        }
+    }
+}
+
+// GEM straight from the coefficients to dAffinePara, elimination and
+// back-substitution both run across lanes and C is never touched
+SOLVER_INLINE void BatchSolver::solve_gem_fused_kernel(int count, const int64_t (*i64EqualCoeff)[7][7], int iParaNum,
+                                                       double (*dAffinePara)[6], int *iStatus)
+{
+    const int n = iParaNum;
+
+    ArenaScope scope(Arena::local());
+    double (*T)[7][BATCH_LANES] = Arena::local().alloc<double[7][BATCH_LANES]>(7);
+    double (*X)[BATCH_LANES] = Arena::local().alloc<double[BATCH_LANES]>(6);
+
+    for (int base = 0; base < count; base += BATCH_LANES) {
+        int num = (count - base < BATCH_LANES) ? count - base : BATCH_LANES;
+        int st[BATCH_LANES];
+
+        // short batches repeat the last system in the idle lanes
+        for (int p = 0; p < n; p++) {
+            for (int q = 0; q < n + 1; q++) {
+                int64_t r = (p == q) ? ridge : 0;
+
+                LANE_LOOP(l) T[p][q][l] = (double)ridge_add(i64EqualCoeff[base + min(l, num - 1)][p + 1][q], r);
+            }
+        }
+
+        LANE_LOOP(l) st[l] = SOLVE_OK;
+
+        for (int k = 0; k < n; k++) {
+            int m[BATCH_LANES];
+            double t[BATCH_LANES];
+            double M[BATCH_LANES];
+
+            // find column max, first maximum wins as in pivot_mat
+            LANE_LOOP(l) {
+                m[l] = k;
+                t[l] = fabs(T[k][k][l]);
+            }
+
+            for (int i = k + 1; i < n; i++) {
+                LANE_LOOP(l) {
+                    bool c = fabs(T[i][k][l]) > t[l];
+                    t[l] = c ? fabs(T[i][k][l]) : t[l];
+                    m[l] = c ? i : m[l];
+                }
+            }
+
+            // swap rows k and m with selects
+            for (int i = k + 1; i < n; i++) {
+                for (int j = k; j < n + 1; j++) {
+                    LANE_LOOP(l) {
+                        bool c = (m[l] == i);
+                        double a = T[k][j][l];
+                        double b = T[i][j][l];
+                        T[k][j][l] = c ? b : a;
+                        T[i][j][l] = c ? a : b;
+                    }
+                }
+            }
+
+            // a failed lane keeps running on a dummy pivot
+            LANE_LOOP(l) {
+                bool z = (T[k][k][l] == 0.);
+                st[l] = z ? SOLVE_SINGULAR : st[l];
+                M[l] = z ? 1.0 : T[k][k][l];
+            }
+
+            gem_step<BATCH_LANES>(k, n, M, [&](int i, int j, int l) -> double & { return T[i][j][l]; });
+        }
+
+        gem_back<BATCH_LANES>(n, [&](int i, int j, int l) -> double & { return T[i][j][l]; },
+                              [&](int i, int l) -> double & { return X[i][l]; });
+
+        for (int l = 0; l < num; l++) {
+            for (int i = 0; i < n; i++) {
+                dAffinePara[base + l][i] = (st[l] == SOLVE_OK) ? X[i][l] : 0;
+            }
+
+            iStatus[base + l] = st[l];
+        }
+    }
+}
+
+void BatchSolver::solve_gem_fused(int count, const int64_t (*i64EqualCoeff)[7][7], int iParaNum,
+                                  double (*dAffinePara)[6], int *iStatus)
+{
+    BatchSolverKernel::solve_gem_fused(this, count, i64EqualCoeff, iParaNum, dAffinePara, iStatus);
+}
+
+void BatchSolver::solve_dfa(int count, const int64_t (*i64EqualCoeff)[7][7], int iParaNum,
+                            double (*dAffinePara)[6], int *iStatus, int frac)
+{
+    for (int base = 0; base < count; base += BATCH_LANES) {
+        int num = (count - base < BATCH_LANES) ? count - base : BATCH_LANES;
+
+        for (int l = 0; l < num; l++) {
+            load_data(l, i64EqualCoeff[base + l], iParaNum);
+        }
+
+        method_dfa(iParaNum);
+
+        for (int l = 0; l < num; l++) {
+            iStatus[base + l] = save_data(l, dAffinePara[base + l], iParaNum, frac);
+        }
+    }
+}
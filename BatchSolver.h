@@ -0,0 +1,69 @@
+/*
+ * BatchSolver.h
+ *
+ *  Created on: 2026-10-19 05:37
+ */
+
+#ifndef __BATCH_SOLVER__
+#define __BATCH_SOLVER__
+
+#include <cstdint>
+
+#include "EquationSolver.h"
+
+#define BATCH_LANES 8
+
+enum {
+    SOLVE_OK = 0,
+    SOLVE_SINGULAR,
+    SOLVE_INVALID,  // parameter count outside 1-6
+};
+
+enum {
+    BATCH_GEM = 0,
+    BATCH_DFA,
+};
+
+// solves BATCH_LANES systems at once, lane-innermost so every step
+// vectorizes across systems; a zero pivot marks the lane as failed and
+// continues with a dummy pivot instead of leaving the loop
+class BatchSolver
+{
+private:
+    double C[7][7][BATCH_LANES] = {};
+    int status[BATCH_LANES] = {};
+    int64_t ridge = 0;
+
+    // method bodies, inlined into the per-ISA clones of BatchSolverKernel
+    friend struct BatchSolverKernel;
+
+    void method_gem_kernel(int n);
+    void method_dfa_kernel(int n);
+    void solve_gem_fused_kernel(int count, const int64_t (*i64EqualCoeff)[7][7], int iParaNum,
+                                double (*dAffinePara)[6], int *iStatus);
+
+public:
+    void set_ridge(int64_t val);
+
+    void load_data(int lane, const int64_t i64EqualCoeff[7][7], int iParaNum);
+    // n = 4 or 6 and inputs below 2^14 in magnitude, see grad_accum
+    void load_grad(int lane, const int32_t *piResi, const int32_t *piGradX, const int32_t *piGradY,
+                   int stride, int width, int height, int iParaNum);
+
+    int save_data_gem(int lane, double dAffinePara[6], int iParaNum);
+    int save_data(int lane, double dAffinePara[6], int iParaNum, int frac);
+
+    int get_status(int lane) const;
+
+    void method_gem(int n);
+    void method_dfa(int n);
+
+    void solve_gem(int count, const int64_t (*i64EqualCoeff)[7][7], int iParaNum,
+                   double (*dAffinePara)[6], int *iStatus);
+    void solve_gem_fused(int count, const int64_t (*i64EqualCoeff)[7][7], int iParaNum,
+                         double (*dAffinePara)[6], int *iStatus);
+    void solve_dfa(int count, const int64_t (*i64EqualCoeff)[7][7], int iParaNum,
+                   double (*dAffinePara)[6], int *iStatus, int frac);
+};
+
+#endif // __BATCH_SOLVER__
@@ -0,0 +1,361 @@
+/*
+ * BigInt.cpp
+ *
+ *  Created on: 2026-10-19 05:33
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "BigInt.h"
+
+using namespace std;
+
+BigInt::BigInt(int64_t val)
+{
+    uint64_t u = (val < 0) ? (uint64_t)0 - (uint64_t)val : (uint64_t)val;
+
+    neg = (val < 0);
+
+    while (u) {
+        mag.push_back((uint32_t)u);
+        u >>= 32;
+    }
+}
+
+void BigInt::trim(void)
+{
+    while (!mag.empty() && mag.back() == 0) {
+        mag.pop_back();
+    }
+
+    if (mag.empty()) {
+        neg = false;
+    }
+}
+
+int BigInt::cmp_mag(const vector<uint32_t> &a, const vector<uint32_t> &b)
+{
+    if (a.size() != b.size()) {
+        return (a.size() < b.size()) ? -1 : 1;
+    }
+
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) {
+            return (a[i] < b[i]) ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+void BigInt::add_mag(vector<uint32_t> &r, const vector<uint32_t> &a, const vector<uint32_t> &b)
+{
+    const vector<uint32_t> &l = (a.size() >= b.size()) ? a : b;
+    const vector<uint32_t> &s = (a.size() >= b.size()) ? b : a;
+    uint64_t k = 0;
+
+    r.resize(l.size() + 1);
+
+    for (size_t i = 0; i < l.size(); i++) {
+        uint64_t t = (uint64_t)l[i] + (i < s.size() ? s[i] : 0) + k;
+        r[i] = (uint32_t)t;
+        k = t >> 32;
+    }
+
+    r[l.size()] = (uint32_t)k;
+}
+
+// requires |a| >= |b|
+void BigInt::sub_mag(vector<uint32_t> &r, const vector<uint32_t> &a, const vector<uint32_t> &b)
+{
+    int64_t k = 0;
+
+    r.resize(a.size());
+
+    for (size_t i = 0; i < a.size(); i++) {
+        int64_t t = (int64_t)a[i] - (i < b.size() ? b[i] : 0) - k;
+        r[i] = (uint32_t)t;
+        k = (t < 0) ? 1 : 0;
+    }
+}
+
+void BigInt::mul_mag(vector<uint32_t> &r, const vector<uint32_t> &a, const vector<uint32_t> &b)
+{
+    r.assign(a.size() + b.size(), 0);
+
+    for (size_t i = 0; i < a.size(); i++) {
+        uint64_t k = 0;
+
+        for (size_t j = 0; j < b.size(); j++) {
+            uint64_t t = (uint64_t)a[i] * b[j] + r[i + j] + k;
+            r[i + j] = (uint32_t)t;
+            k = t >> 32;
+        }
+
+        r[i + b.size()] = (uint32_t)k;
+    }
+}
+
+// Knuth algorithm D, requires b non-zero and trimmed
+void BigInt::div_mag(vector<uint32_t> &q, vector<uint32_t> &r,
+                     const vector<uint32_t> &a, const vector<uint32_t> &b)
+{
+    const uint64_t base = 1ULL << 32;
+    int m = (int)a.size();
+    int n = (int)b.size();
+
+    if (m < n) {
+        q.clear();
+        r = a;
+        return;
+    }
+
+    q.assign(m - n + 1, 0);
+
+    if (n == 1) {
+        uint64_t k = 0;
+
+        for (int j = m - 1; j >= 0; j--) {
+            uint64_t t = (k << 32) | a[j];
+            q[j] = (uint32_t)(t / b[0]);
+            k = t % b[0];
+        }
+
+        r.assign(1, (uint32_t)k);
+        return;
+    }
+
+    // normalize so that the top bit of the divisor is set
+    int s = __builtin_clz(b[n - 1]);
+    vector<uint32_t> un(m + 1), vn(n);
+
+    for (int i = n - 1; i > 0; i--) {
+        vn[i] = (b[i] << s) | (s ? (uint32_t)((uint64_t)b[i - 1] >> (32 - s)) : 0);
+    }
+    vn[0] = b[0] << s;
+
+    un[m] = s ? (uint32_t)((uint64_t)a[m - 1] >> (32 - s)) : 0;
+    for (int i = m - 1; i > 0; i--) {
+        un[i] = (a[i] << s) | (s ? (uint32_t)((uint64_t)a[i - 1] >> (32 - s)) : 0);
+    }
+    un[0] = a[0] << s;
+
+    for (int j = m - n; j >= 0; j--) {
+        uint64_t num  = ((uint64_t)un[j + n] << 32) | un[j + n - 1];
+        uint64_t qhat = num / vn[n - 1];
+        uint64_t rhat = num % vn[n - 1];
+
+        while (qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+            qhat--;
+            rhat += vn[n - 1];
+            if (rhat >= base) {
+                break;
+            }
+        }
+
+        // multiply and subtract
+        int64_t k = 0;
+        int64_t t = 0;
+
+        for (int i = 0; i < n; i++) {
+            uint64_t p = qhat * vn[i];
+            t = (int64_t)un[i + j] - k - (int64_t)(p & 0xFFFFFFFF);
+            un[i + j] = (uint32_t)t;
+            k = (int64_t)(p >> 32) - (t >> 32);
+        }
+        t = (int64_t)un[j + n] - k;
+        un[j + n] = (uint32_t)t;
+
+        q[j] = (uint32_t)qhat;
+
+        // add back
+        if (t < 0) {
+            uint64_t c = 0;
+
+            q[j]--;
+            for (int i = 0; i < n; i++) {
+                uint64_t u = (uint64_t)un[i + j] + vn[i] + c;
+                un[i + j] = (uint32_t)u;
+                c = u >> 32;
+            }
+            un[j + n] += (uint32_t)c;
+        }
+    }
+
+    // unnormalize the remainder
+    r.resize(n);
+    for (int i = 0; i < n - 1; i++) {
+        r[i] = (un[i] >> s) | (s ? (uint32_t)((uint64_t)un[i + 1] << (32 - s)) : 0);
+    }
+    r[n - 1] = un[n - 1] >> s;
+}
+
+bool BigInt::is_zero(void) const
+{
+    return mag.empty();
+}
+
+int BigInt::sign(void) const
+{
+    return mag.empty() ? 0 : (neg ? -1 : 1);
+}
+
+int BigInt::bits(void) const
+{
+    if (mag.empty()) {
+        return 0;
+    }
+
+    return (int)(mag.size() - 1) * 32 + (32 - __builtin_clz(mag.back()));
+}
+
+double BigInt::to_double(void) const
+{
+    double val = 0.0;
+    int top = (int)mag.size() - 1;
+    int low = max(0, top - 2);
+
+    // the top three limbs hold at least 65 significant bits
+    for (int i = top; i >= low; i--) {
+        val = val * 4294967296.0 + mag[i];
+    }
+
+    val = ldexp(val, low * 32);
+
+    return neg ? -val : val;
+}
+
+string BigInt::to_string(void) const
+{
+    if (mag.empty()) {
+        return "0";
+    }
+
+    string str;
+    vector<uint32_t> q, r, t = mag;
+    const vector<uint32_t> ten9(1, 1000000000);
+
+    while (!t.empty()) {
+        div_mag(q, r, t, ten9);
+
+        uint32_t d = r.empty() ? 0 : r[0];
+
+        while (!q.empty() && q.back() == 0) {
+            q.pop_back();
+        }
+
+        bool last = q.empty();
+
+        for (int i = 0; i < 9 && (!last || d); i++) {
+            str.push_back((char)('0' + d % 10));
+            d /= 10;
+        }
+
+        t = q;
+    }
+
+    if (neg) {
+        str.push_back('-');
+    }
+
+    reverse(str.begin(), str.end());
+
+    return str;
+}
+
+BigInt BigInt::operator-(void) const
+{
+    BigInt res = *this;
+
+    res.neg = !res.mag.empty() && !neg;
+
+    return res;
+}
+
+BigInt BigInt::operator+(const BigInt &b) const
+{
+    BigInt res;
+
+    if (neg == b.neg) {
+        add_mag(res.mag, mag, b.mag);
+        res.neg = neg;
+    } else if (cmp_mag(mag, b.mag) >= 0) {
+        sub_mag(res.mag, mag, b.mag);
+        res.neg = neg;
+    } else {
+        sub_mag(res.mag, b.mag, mag);
+        res.neg = b.neg;
+    }
+
+    res.trim();
+
+    return res;
+}
+
+BigInt BigInt::operator-(const BigInt &b) const
+{
+    return *this + (-b);
+}
+
+BigInt BigInt::operator*(const BigInt &b) const
+{
+    BigInt res;
+
+    mul_mag(res.mag, mag, b.mag);
+    res.neg = (neg != b.neg);
+    res.trim();
+
+    return res;
+}
+
+// truncating division, the divisor must be non-zero
+BigInt BigInt::operator/(const BigInt &b) const
+{
+    BigInt res;
+    vector<uint32_t> r;
+
+    div_mag(res.mag, r, mag, b.mag);
+    res.neg = (neg != b.neg);
+    res.trim();
+
+    return res;
+}
+
+BigInt BigInt::operator%(const BigInt &b) const
+{
+    BigInt res;
+    vector<uint32_t> q;
+
+    div_mag(q, res.mag, mag, b.mag);
+    res.neg = neg;
+    res.trim();
+
+    return res;
+}
+
+bool BigInt::operator==(const BigInt &b) const
+{
+    return (neg == b.neg) && (mag == b.mag);
+}
+
+bool BigInt::operator!=(const BigInt &b) const
+{
+    return !(*this == b);
+}
+
+// a / b rounded to double with at most one ulp of error
+double BigInt::ratio(const BigInt &a, const BigInt &b)
+{
+    if (a.is_zero()) {
+        return 0.0;
+    }
+
+    int s = max(0, 64 + b.bits() - a.bits());
+    BigInt p;
+
+    p.mag.assign(s / 32 + 1, 0);
+    p.mag[s / 32] = 1U << (s % 32);
+
+    return ldexp(((a * p) / b).to_double(), -s);
+}
@@ -0,0 +1,55 @@
+/*
+ * BigInt.h
+ *
+ *  Created on: 2026-10-19 05:33
+ */
+
+#ifndef __BIG_INT__
+#define __BIG_INT__
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// arbitrary-precision signed integer, sign-magnitude with 32-bit limbs
+class BigInt
+{
+private:
+    bool neg = false;
+    std::vector<uint32_t> mag;
+
+    void trim(void);
+
+    static int cmp_mag(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b);
+    static void add_mag(std::vector<uint32_t> &r, const std::vector<uint32_t> &a, const std::vector<uint32_t> &b);
+    static void sub_mag(std::vector<uint32_t> &r, const std::vector<uint32_t> &a, const std::vector<uint32_t> &b);
+    static void mul_mag(std::vector<uint32_t> &r, const std::vector<uint32_t> &a, const std::vector<uint32_t> &b);
+    static void div_mag(std::vector<uint32_t> &q, std::vector<uint32_t> &r,
+                        const std::vector<uint32_t> &a, const std::vector<uint32_t> &b);
+
+public:
+    BigInt(void) = default;
+    BigInt(int64_t val);
+
+    bool is_zero(void) const;
+    int sign(void) const;
+    int bits(void) const;
+
+    double to_double(void) const;
+    std::string to_string(void) const;
+
+    BigInt operator-(void) const;
+
+    BigInt operator+(const BigInt &b) const;
+    BigInt operator-(const BigInt &b) const;
+    BigInt operator*(const BigInt &b) const;
+    BigInt operator/(const BigInt &b) const;
+    BigInt operator%(const BigInt &b) const;
+
+    bool operator==(const BigInt &b) const;
+    bool operator!=(const BigInt &b) const;
+
+    static double ratio(const BigInt &a, const BigInt &b);
+};
+
+#endif // __BIG_INT__
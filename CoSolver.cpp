@@ -0,0 +1,97 @@
+/*
+ * CoSolver.cpp
+ *
+ *  Created on: 2026-10-19 05:45
+ */
+
+#include "CoSolver.h"
+
+using namespace std;
+
+CoSolver::Awaiter::Awaiter(CoSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum)
+    : solver(solver), coeff(i64EqualCoeff), n(iParaNum), res()
+{
+    if (n < 1 || n > 6) {
+        res.status = SOLVE_INVALID;
+    }
+}
+
+bool CoSolver::Awaiter::await_suspend(coroutine_handle<> h)
+{
+    handle = h;
+
+    solver->pend[n].push_back(this);
+
+    if ((int)solver->pend[n].size() < BATCH_LANES) {
+        return true;
+    }
+
+    solver->solve_batch(n);
+
+    // this coroutine is ready as well, keep running it instead of suspending
+    solver->ready.pop_back();
+
+    return false;
+}
+
+CoSolver::CoSolver(int method, int frac) : method(method), frac(frac)
+{
+}
+
+CoSolver::Awaiter CoSolver::solve(const int64_t i64EqualCoeff[7][7], int iParaNum)
+{
+    return Awaiter(this, i64EqualCoeff, iParaNum);
+}
+
+void CoSolver::solve_batch(int n)
+{
+    vector<Awaiter *> &group = pend[n];
+    int num = (int)group.size();
+
+    for (int l = 0; l < num; l++) {
+        batch.load_data(l, group[l]->coeff, n);
+    }
+
+    if (method == BATCH_DFA) {
+        batch.method_dfa(n);
+    } else {
+        batch.method_gem(n);
+    }
+
+    for (int l = 0; l < num; l++) {
+        CoSolveResult &res = group[l]->res;
+
+        if (method == BATCH_DFA) {
+            res.status = batch.save_data(l, res.dAffinePara, n, frac);
+        } else {
+            res.status = batch.save_data_gem(l, res.dAffinePara, n);
+        }
+
+        ready.push_back(group[l]);
+    }
+
+    group.clear();
+}
+
+void CoSolver::flush(void)
+{
+    while (true) {
+        if (ready.empty()) {
+            for (int n = 1; n < 7; n++) {
+                if (!pend[n].empty()) {
+                    solve_batch(n);
+                }
+            }
+
+            if (ready.empty()) {
+                break;
+            }
+        }
+
+        // a resumed coroutine may queue new solves, keep going until idle
+        Awaiter *aw = ready.back();
+
+        ready.pop_back();
+        aw->handle.resume();
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * CoSolver.h
+ *
+ *  Created on: 2026-10-19 05:45
+ */
+
+#ifndef __CO_SOLVER__
+#define __CO_SOLVER__
+
+#include <vector>
+#include <exception>
+#include <coroutine>
+
+#include "BatchSolver.h"
+
+struct CoSolveResult {
+    int status;
+    double dAffinePara[6];
+};
+
+// fire-and-forget coroutine, runs eagerly until its first co_await
+struct CoTask {
+    struct promise_type {
+        CoTask get_return_object(void) { return {}; }
+        std::suspend_never initial_suspend(void) { return {}; }
+        std::suspend_never final_suspend(void) noexcept { return {}; }
+        void return_void(void) {}
+        void unhandled_exception(void) { std::terminate(); }
+    };
+};
+
+// co_await solver.solve(coeff, n) parks the coroutine in a per-size batch,
+// a full batch is solved at once, flush() solves the partial ones and
+// resumes every coroutine whose result is ready
+class CoSolver
+{
+public:
+    class Awaiter
+    {
+    private:
+        friend class CoSolver;
+
+        CoSolver *solver;
+        const int64_t (*coeff)[7];
+        int n;
+        CoSolveResult res;
+        std::coroutine_handle<> handle;
+
+    public:
+        Awaiter(CoSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum);
+
+        // an invalid size completes at once with SOLVE_INVALID and zeros
+        bool await_ready(void) const { return res.status == SOLVE_INVALID; }
+        bool await_suspend(std::coroutine_handle<> h);
+        CoSolveResult await_resume(void) const { return res; }
+    };
+
+private:
+    int method;
+    int frac;
+    BatchSolver batch;
+
+    std::vector<Awaiter *> pend[7];
+    std::vector<Awaiter *> ready;
+
+    void solve_batch(int n);
+
+public:
+    CoSolver(int method, int frac = 8);
+
+    Awaiter solve(const int64_t i64EqualCoeff[7][7], int iParaNum);
+
+    void flush(void);
+};
+
+#endif // __CO_SOLVER__
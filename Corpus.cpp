@@ -0,0 +1,192 @@
+/*
+ * Corpus.cpp
+ *
+ *  Created on: 2026-10-19 05:33
+ */
+
+#include <cstring>
+
+#include "Corpus.h"
+
+Corpus::Corpus(uint64_t seed) : rng(seed)
+{
+}
+
+const char *Corpus::kind_name(int kind)
+{
+    static const char *names[CORPUS_KIND_NUM] = {
+        "small", "large", "normal", "pivot", "near-singular", "singular"
+    };
+
+    return (kind >= 0 && kind < CORPUS_KIND_NUM) ? names[kind] : "unknown";
+}
+
+int64_t Corpus::rand_int(int64_t lo, int64_t hi)
+{
+    return lo + (int64_t)(rng() % (uint64_t)(hi - lo + 1));
+}
+
+void Corpus::gen_small(int64_t i64EqualCoeff[7][7], int n)
+{
+    for (int row = 0; row < n; row++) {
+        for (int i = 0; i < n + 1; i++) {
+            i64EqualCoeff[row + 1][i] = rand_int(-16, 16);
+        }
+    }
+}
+
+void Corpus::gen_large(int64_t i64EqualCoeff[7][7], int n)
+{
+    for (int row = 0; row < n; row++) {
+        for (int i = 0; i < n + 1; i++) {
+            i64EqualCoeff[row + 1][i] = rand_int(-(1LL << 34), 1LL << 34);
+        }
+    }
+}
+
+// same accumulation as the affine gradient search in the encoder,
+// 8x8 block with 10-bit gradients and residuals
+void Corpus::gen_normal(int64_t i64EqualCoeff[7][7], int n)
+{
+    for (int row = 0; row < n; row++) {
+        for (int i = 0; i < n + 1; i++) {
+            i64EqualCoeff[row + 1][i] = 0;
+        }
+    }
+
+    int64_t a = rand_int(-8, 8);
+    int64_t b = rand_int(-8, 8);
+
+    for (int j = 0; j < 8; j++) {
+        for (int k = 0; k < 8; k++) {
+            int64_t gx = rand_int(-1023, 1023);
+            int64_t gy = rand_int(-1023, 1023);
+            int64_t rs = (a * gx + b * gy) / 4 + rand_int(-64, 64);
+            int64_t cx = ((k >> 2) << 2) + 2;
+            int64_t cy = ((j >> 2) << 2) + 2;
+            int64_t iC[6];
+
+            if (n == 6) {
+                iC[0] = gx;
+                iC[1] = cx * gx;
+                iC[2] = gy;
+                iC[3] = cx * gy;
+                iC[4] = cy * gx;
+                iC[5] = cy * gy;
+            } else {
+                iC[0] = gx;
+                iC[1] = cx * gx + cy * gy;
+                iC[2] = gy;
+                iC[3] = cy * gx - cx * gy;
+            }
+
+            for (int col = 0; col < n; col++) {
+                for (int row = 0; row < n; row++) {
+                    i64EqualCoeff[col + 1][row] += iC[col] * iC[row];
+                }
+                i64EqualCoeff[col + 1][n] += (iC[col] * rs) * 8;
+            }
+        }
+    }
+}
+
+void Corpus::gen_pivot(int64_t i64EqualCoeff[7][7], int n)
+{
+    gen_small(i64EqualCoeff, n);
+
+    for (int row = 0; row < n - 1; row++) {
+        i64EqualCoeff[row + 1][row] = 0;
+    }
+}
+
+void Corpus::gen_near_singular(int64_t i64EqualCoeff[7][7], int n)
+{
+    gen_small(i64EqualCoeff, n);
+
+    for (int i = 0; i < n + 1; i++) {
+        int64_t sum = 0;
+
+        for (int row = 0; row < n - 1; row++) {
+            sum += i64EqualCoeff[row + 1][i];
+        }
+
+        i64EqualCoeff[n][i] = sum;
+    }
+
+    i64EqualCoeff[n][rand_int(0, n - 1)] += (rng() & 1) ? 1 : -1;
+}
+
+void Corpus::gen_singular(int64_t i64EqualCoeff[7][7], int n)
+{
+    gen_small(i64EqualCoeff, n);
+
+    int src = (int)rand_int(0, n - 2);
+    int dst = (int)rand_int(src + 1, n - 1);
+
+    memcpy(i64EqualCoeff[dst + 1], i64EqualCoeff[src + 1], sizeof(int64_t) * (n + 1));
+}
+
+void Corpus::generate(int64_t i64EqualCoeff[7][7], int n, int kind)
+{
+    switch (kind) {
+        case CORPUS_SMALL:
+            gen_small(i64EqualCoeff, n);
+            break;
+        case CORPUS_LARGE:
+            gen_large(i64EqualCoeff, n);
+            break;
+        case CORPUS_NORMAL:
+            gen_normal(i64EqualCoeff, n);
+            break;
+        case CORPUS_PIVOT:
+            gen_pivot(i64EqualCoeff, n);
+            break;
+        case CORPUS_NEAR_SINGULAR:
+            gen_near_singular(i64EqualCoeff, n);
+            break;
+        case CORPUS_SINGULAR:
+        default:
+            gen_singular(i64EqualCoeff, n);
+            break;
+    }
+}
+
+// n x (n + 1) row-major system built around an integer solution, so the
+// exact answer is known without a reference solve; the random matrix keeps
+// the row swaps of partial pivoting busy and every sum stays below 2^38
+void Corpus::generate_solved(int64_t *coeff, int n, int64_t x[])
+{
+    for (int i = 0; i < n; i++) {
+        x[i] = rand_int(-1024, 1024);
+    }
+
+    for (int row = 0; row < n; row++) {
+        int64_t *r = &coeff[(size_t)row * (n + 1)];
+        int64_t b = 0;
+
+        for (int i = 0; i < n; i++) {
+            r[i] = rand_int(-(1LL << 20), 1LL << 20);
+        }
+
+        for (int i = 0; i < n; i++) {
+            b += r[i] * x[i];
+        }
+
+        r[n] = b;
+    }
+}
+
+// residual and gradient planes for load_grad, uniform over the whole
+// range grad_accum accepts so the 32-bit band moments run at their limit
+void Corpus::generate_planes(int32_t *piResi, int32_t *piGradX, int32_t *piGradY, int stride, int width, int height)
+{
+    const int64_t lim = (1 << 14) - 1;
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            piResi[(size_t)y * stride + x] = (int32_t)rand_int(-lim, lim);
+            piGradX[(size_t)y * stride + x] = (int32_t)rand_int(-lim, lim);
+            piGradY[(size_t)y * stride + x] = (int32_t)rand_int(-lim, lim);
+        }
+    }
+}
@@ -0,0 +1,48 @@
+/*
+ * Corpus.h
+ *
+ *  Created on: 2026-10-19 05:33
+ */
+
+#ifndef __CORPUS__
+#define __CORPUS__
+
+#include <random>
+#include <cstdint>
+
+enum {
+    CORPUS_SMALL = 0,       // small random integers
+    CORPUS_LARGE,           // random integers up to 2^34
+    CORPUS_NORMAL,          // affine normal equations from random gradients
+    CORPUS_PIVOT,           // zero leading diagonal, forces row swaps
+    CORPUS_NEAR_SINGULAR,   // one row is a combination of the others plus noise
+    CORPUS_SINGULAR,        // one row duplicates another
+    CORPUS_KIND_NUM
+};
+
+// reproducible generator of coefficient matrices in i64EqualCoeff layout
+class Corpus
+{
+private:
+    std::mt19937_64 rng;
+
+    int64_t rand_int(int64_t lo, int64_t hi);
+
+    void gen_small(int64_t i64EqualCoeff[7][7], int n);
+    void gen_large(int64_t i64EqualCoeff[7][7], int n);
+    void gen_normal(int64_t i64EqualCoeff[7][7], int n);
+    void gen_pivot(int64_t i64EqualCoeff[7][7], int n);
+    void gen_near_singular(int64_t i64EqualCoeff[7][7], int n);
+    void gen_singular(int64_t i64EqualCoeff[7][7], int n);
+
+public:
+    Corpus(uint64_t seed);
+
+    static const char *kind_name(int kind);
+
+    void generate(int64_t i64EqualCoeff[7][7], int n, int kind);
+    void generate_solved(int64_t *coeff, int n, int64_t x[]);
+    void generate_planes(int32_t *piResi, int32_t *piGradX, int32_t *piGradY, int stride, int width, int height);
+};
+
+#endif // __CORPUS__
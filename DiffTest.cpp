@@ -0,0 +1,702 @@
+/*
+ * DiffTest.cpp
+ *
+ *  Created on: 2026-10-19 05:33
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cinttypes>
+#include <vector>
+
+#include "Corpus.h"
+#include "Methods.h"
+#include "BatchSolver.h"
+#include "LUSolver.h"
+#include "DiffTest.h"
+#include "ReferenceSolver.h"
+#include "EquationSolverInline.h"
+
+using namespace std;
+
+static const char *bin_names[ERR_BIN_NUM] = {
+    "<1e-12", "<1e-9", "<1e-6", "<1e-3", "<1", ">=1", "zero", "nan", "sing-ok", "sing-bad"
+};
+
+// ridge for the singular normal equations, about 1/30 of their diagonal
+#define RIDGE_SINGULAR 16
+
+// band the get_cond estimate must fall in, as a multiple of the true cond_1
+#define DET_COND_LO 1e-3
+#define DET_COND_HI 1e1
+
+DiffTest::DiffTest(uint64_t seed) : seed(seed)
+{
+}
+
+// the encoder's per-pixel outer-product build of the normal equations,
+// 4x4 sub-block centers, the ground truth for load_grad
+static void grad_direct(int64_t i64EqualCoeff[7][7], const int32_t *piResi, const int32_t *piGradX,
+                        const int32_t *piGradY, int stride, int width, int height, int n)
+{
+    memset(i64EqualCoeff, 0x00, sizeof(int64_t) * 49);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int64_t gx = piGradX[(size_t)y * stride + x];
+            int64_t gy = piGradY[(size_t)y * stride + x];
+            int64_t rs = piResi[(size_t)y * stride + x];
+            int64_t cx = ((x >> 2) << 2) + 2;
+            int64_t cy = ((y >> 2) << 2) + 2;
+            int64_t iC[6];
+
+            if (n == 6) {
+                iC[0] = gx;
+                iC[1] = cx * gx;
+                iC[2] = gy;
+                iC[3] = cx * gy;
+                iC[4] = cy * gx;
+                iC[5] = cy * gy;
+            } else {
+                iC[0] = gx;
+                iC[1] = cx * gx + cy * gy;
+                iC[2] = gy;
+                iC[3] = cy * gx - cx * gy;
+            }
+
+            for (int col = 0; col < n; col++) {
+                for (int row = 0; row < n; row++) {
+                    i64EqualCoeff[col + 1][row] += iC[col] * iC[row];
+                }
+                i64EqualCoeff[col + 1][n] += (iC[col] * rs) * 8;
+            }
+        }
+    }
+}
+
+// b / d at frac = 0 and the integer each rounding mode must give for it
+// inside [-3, 3]: ties of both signs, a negative divisor, quarters and
+// values clipped at either end
+struct RoundCase {
+    int64_t b;
+    int64_t d;
+    int32_t q[4];   // ROUND_ZERO, ROUND_FLOOR, ROUND_HALF_UP, ROUND_HALF_AWAY
+};
+
+static const RoundCase round_cases[] = {
+    { -9,  2, { -3, -3, -3, -3 } },     // -4.5 clipped
+    { -5,  2, { -2, -3, -2, -3 } },     // -2.5
+    { -3,  2, { -1, -2, -1, -2 } },     // -1.5
+    { -1,  2, {  0, -1,  0, -1 } },     // -0.5
+    { -5,  4, { -1, -2, -1, -1 } },     // -1.25
+    { -7,  4, { -1, -2, -2, -2 } },     // -1.75
+    {  3, -2, { -1, -2, -1, -2 } },     // -1.5 with the sign on the divisor
+    {  1,  2, {  0,  0,  1,  1 } },     // 0.5
+    {  3,  2, {  1,  1,  2,  2 } },     // 1.5
+    {  5,  2, {  2,  2,  3,  3 } },     // 2.5
+    {  9,  2, {  3,  3,  3,  3 } },     // 4.5 clipped
+    { -7,  1, { -3, -3, -3, -3 } },     // -7 clipped
+};
+
+int DiffTest::classify(const double *res, const double *ref, int n, bool singular)
+{
+    bool zero = true;
+    double err = 0.0;
+    double mag = 1.0;
+
+    for (int i = 0; i < n; i++) {
+        if (std::isnan(res[i])) {
+            return singular ? ERR_SING_BAD : ERR_NAN;
+        }
+
+        if (res[i] != 0.0) {
+            zero = false;
+        }
+
+        err = max(err, fabs(res[i] - ref[i]));
+        mag = max(mag, fabs(ref[i]));
+    }
+
+    if (singular) {
+        return zero ? ERR_SING_OK : ERR_SING_BAD;
+    }
+
+    if (zero) {
+        for (int i = 0; i < n; i++) {
+            if (ref[i] != 0.0) {
+                return ERR_ZERO;
+            }
+        }
+    }
+
+    err /= mag;
+
+    if (!(err < 1e0)) {
+        return ERR_HUGE;
+    } else if (err < 1e-12) {
+        return ERR_1E12;
+    } else if (err < 1e-9) {
+        return ERR_1E9;
+    } else if (err < 1e-6) {
+        return ERR_1E6;
+    } else if (err < 1e-3) {
+        return ERR_1E3;
+    } else {
+        return ERR_1E0;
+    }
+}
+
+void DiffTest::run(long count)
+{
+    static const int sizes[] = { 4, 6 };
+
+    EquationSolver *solver = new EquationSolver();
+    ReferenceSolver *reference = new ReferenceSolver();
+
+    // FNV-1a over the raw result bits, compared across builds and ISAs
+    vector<uint64_t> digest(solver_method_num, 0xcbf29ce484222325ULL);
+
+    for (int n : sizes) {
+        for (int kind = 0; kind < CORPUS_KIND_NUM; kind++) {
+            Corpus corpus(seed + kind * 16 + n);
+            vector<long> hist(solver_method_num * ERR_BIN_NUM, 0);
+
+            for (long c = 0; c < count; c++) {
+                int64_t coeff[7][7] = { 0 };
+                double ref[6] = { 0.0 };
+
+                corpus.generate(coeff, n, kind);
+
+                reference->load_data(coeff, n);
+                reference->method_bareiss(n);
+                reference->save_data(ref, n);
+
+                for (int m = 0; m < solver_method_num; m++) {
+                    double res[6] = { 0.0 };
+
+                    solver_methods[m].solve(solver, coeff, n, res);
+
+                    const uint8_t *p = (const uint8_t *)res;
+                    for (size_t b = 0; b < sizeof(double) * n; b++) {
+                        digest[m] = (digest[m] ^ p[b]) * 0x100000001b3ULL;
+                    }
+
+                    hist[m * ERR_BIN_NUM + classify(res, ref, n, reference->is_singular())]++;
+                }
+            }
+
+            printf("------------------------------- %-13s ----------------- n = %d count = %ld\n",
+                   Corpus::kind_name(kind), n, count);
+            printf("%-6s", "method");
+            for (int b = 0; b < ERR_BIN_NUM; b++) {
+                printf("%9s", bin_names[b]);
+            }
+            printf("\n");
+
+            for (int m = 0; m < solver_method_num; m++) {
+                printf("%-6s", solver_methods[m].name);
+                for (int b = 0; b < ERR_BIN_NUM; b++) {
+                    printf("%9ld", hist[m * ERR_BIN_NUM + b]);
+                }
+                printf("\n");
+            }
+        }
+    }
+
+    // LUSolver beyond one panel, against the solution the system was built on
+    static const int large[] = { LU_BLOCK + 1, 100 };
+    uint64_t large_digest[2];
+
+    for (int s = 0; s < 2; s++) {
+        int n = large[s];
+        LUSolver *lu = new LUSolver();
+        Corpus corpus(seed + 1000 + n);
+        vector<int64_t> coeff((size_t)n * (n + 1));
+        vector<int64_t> x(n);
+        vector<double> ref(n), res(n);
+        vector<long> hist(ERR_BIN_NUM, 0);
+        long num = max(count / 10, 1L);
+
+        large_digest[s] = 0xcbf29ce484222325ULL;
+
+        for (long c = 0; c < num; c++) {
+            corpus.generate_solved(coeff.data(), n, x.data());
+
+            for (int i = 0; i < n; i++) {
+                ref[i] = (double)x[i];
+            }
+
+            lu->load_data(coeff.data(), n, n + 1);
+            lu->method_lu();
+            lu->save_data(res.data());
+
+            const uint8_t *p = (const uint8_t *)res.data();
+            for (size_t b = 0; b < sizeof(double) * n; b++) {
+                large_digest[s] = (large_digest[s] ^ p[b]) * 0x100000001b3ULL;
+            }
+
+            hist[classify(res.data(), ref.data(), n, false)]++;
+        }
+
+        printf("------------------------------- %-13s ----------------- n = %d count = %ld\n", "solved", n, num);
+        printf("%-6s", "method");
+        for (int b = 0; b < ERR_BIN_NUM; b++) {
+            printf("%9s", bin_names[b]);
+        }
+        printf("\n%-6s", "lu");
+        for (int b = 0; b < ERR_BIN_NUM; b++) {
+            printf("%9ld", hist[b]);
+        }
+        printf("\n");
+
+        delete(lu);
+    }
+
+    // load_grad on EquationSolver and BatchSolver against load_data of the
+    // direct build, the sums are exact so the results must match bit for bit
+    static const int grad_dims[][2] = { { 8, 8 }, { 16, 16 }, { 13, 7 }, { 64, 32 } };
+    BatchSolver *batch = new BatchSolver();
+
+    for (int n : sizes) {
+        Corpus corpus(seed + 2000 + n);
+        vector<int32_t> resi(64 * 32), gx(64 * 32), gy(64 * 32);
+        long hist[2][ERR_BIN_NUM] = {};
+        long num = max(count / 10, 1L);
+        long diff = 0;
+
+        for (long c = 0; c < num; c++) {
+            int w = grad_dims[c % 4][0];
+            int h = grad_dims[c % 4][1];
+            int64_t coeff[7][7];
+            double ref[6], res[6], bres[6];
+
+            corpus.generate_planes(resi.data(), gx.data(), gy.data(), 64, w, h);
+            grad_direct(coeff, resi.data(), gx.data(), gy.data(), 64, w, h, n);
+
+            solver->load_data(coeff, n);
+            solver->method_gem(n);
+            solver->save_data_gem(ref, n);
+
+            solver->load_grad(resi.data(), gx.data(), gy.data(), 64, w, h, n);
+            solver->method_gem(n);
+            solver->save_data_gem(res, n);
+
+            batch->load_grad(0, resi.data(), gx.data(), gy.data(), 64, w, h, n);
+            batch->method_gem(n);
+            batch->save_data_gem(0, bres, n);
+
+            hist[0][classify(res, ref, n, false)]++;
+            hist[1][classify(bres, ref, n, false)]++;
+
+            diff += (memcmp(res, ref, sizeof(double) * n) != 0) + (memcmp(bres, ref, sizeof(double) * n) != 0);
+        }
+
+        printf("------------------------------- %-13s ----------------- n = %d count = %ld\n", "gradient", n, num);
+        printf("%-6s", "method");
+        for (int b = 0; b < ERR_BIN_NUM; b++) {
+            printf("%9s", bin_names[b]);
+        }
+        printf("\n");
+
+        for (int g = 0; g < 2; g++) {
+            printf("%-6s", g ? "gradb" : "grad");
+            for (int b = 0; b < ERR_BIN_NUM; b++) {
+                printf("%9ld", hist[g][b]);
+            }
+            printf("\n");
+        }
+
+        printf("load_grad results differing from the direct build: %ld\n", diff);
+    }
+
+    // what the ridge is for: normal equations G^T G x = G^T b of singular and
+    // near-singular G, solved with RIDGE_SINGULAR on the diagonal against the
+    // reference solution of the same (A + lambda I) x = b; a result must be
+    // non-zero, within ||G^T b||_2 / lambda, the bound the ridge guarantees,
+    // and match to 1e-9; the dfa kernels are left out, dfa wraps int64 on
+    // normal equations with or without the ridge and dfa4 and dfa5 round
+    // every step to a few percent
+    static const char *ridge_methods[4] = { "gemr", "bfar", "gemir", "gembr" };
+    static const int ridge_kinds[2] = { CORPUS_NEAR_SINGULAR, CORPUS_SINGULAR };
+
+    for (int n : sizes) {
+        Corpus corpus(seed + 2500 + n);
+        long hist[4][ERR_BIN_NUM] = {};
+        long num = max(count / 10, 1L);
+        long bad[4] = {};
+
+        for (long c = 0; c < num; c++) {
+            int64_t g[7][7] = { 0 };
+            int64_t coeff[7][7] = { 0 };
+            int64_t shifted[7][7];
+            double ref[6], res[4][6];
+            double rhs = 0.0;
+            int status;
+
+            corpus.generate(g, n, ridge_kinds[c & 1]);
+
+            for (int i = 0; i < n + 1; i++) {
+                for (int j = 0; j < n; j++) {
+                    for (int r = 0; r < n; r++) {
+                        coeff[j + 1][i] += g[r + 1][j] * g[r + 1][i];
+                    }
+                }
+            }
+
+            for (int j = 0; j < n; j++) {
+                rhs += (double)coeff[j + 1][n] * (double)coeff[j + 1][n];
+            }
+
+            memcpy(shifted, coeff, sizeof(shifted));
+
+            for (int j = 0; j < n; j++) {
+                shifted[j + 1][j] += RIDGE_SINGULAR;
+            }
+
+            reference->load_data(shifted, n);
+            reference->method_bareiss(n);
+            reference->save_data(ref, n);
+
+            solver->set_ridge(RIDGE_SINGULAR);
+
+            solver->load_data(coeff, n);
+            solver->method_gem(n);
+            solver->save_data_gem(res[0], n);
+
+            solver->load_data(coeff, n);
+            solver->method_bfa(n);
+            solver->save_data(res[1], n);
+
+            solver->set_ridge(0);
+
+            if (n == 4) {
+                inline_gem<4>(coeff, res[2], RIDGE_SINGULAR);
+            } else {
+                inline_gem<6>(coeff, res[2], RIDGE_SINGULAR);
+            }
+
+            batch->set_ridge(RIDGE_SINGULAR);
+            batch->solve_gem(1, (const int64_t (*)[7][7])coeff, n, (double (*)[6])res[3], &status);
+            batch->set_ridge(0);
+
+            for (int m = 0; m < 4; m++) {
+                double err = 0.0;
+                double mag = 1.0;
+                double norm = 0.0;
+                bool zero = true;
+
+                for (int i = 0; i < n; i++) {
+                    err = max(err, fabs(res[m][i] - ref[i]));
+                    mag = max(mag, fabs(ref[i]));
+                    norm += res[m][i] * res[m][i];
+                    zero = zero && (res[m][i] == 0.0);
+                }
+
+                hist[m][classify(res[m], ref, n, reference->is_singular())]++;
+                bad[m] += (zero && rhs > 0.0) || !(err / mag < 1e-9) ||
+                          !(norm <= rhs / ((double)RIDGE_SINGULAR * RIDGE_SINGULAR) * (1.0 + 1e-9));
+            }
+        }
+
+        printf("------------------------------- %-13s ----------------- n = %d count = %ld\n", "ridge", n, num);
+        printf("%-6s", "method");
+        for (int b = 0; b < ERR_BIN_NUM; b++) {
+            printf("%9s", bin_names[b]);
+        }
+        printf("%9s\n", "bad");
+
+        for (int m = 0; m < 4; m++) {
+            printf("%-6s", ridge_methods[m]);
+            for (int b = 0; b < ERR_BIN_NUM; b++) {
+                printf("%9ld", hist[m][b]);
+            }
+            printf("%9ld\n", bad[m]);
+        }
+    }
+
+    delete(batch);
+
+    // method_cg where it is meant to run: symmetric positive definite normal
+    // equations, warm-started near the solution as from a neighbouring block
+    for (int n : sizes) {
+        Corpus corpus(seed + 3000 + n);
+        long hist[ERR_BIN_NUM] = {};
+        long num = max(count / 10, 1L);
+        long converged = 0;
+        long fallback = 0;
+        long iters = 0;
+        long stale = 0;
+
+        for (long c = 0; c < num; c++) {
+            int64_t coeff[7][7] = { 0 };
+            double ref[6], res[6];
+
+            corpus.generate(coeff, n, CORPUS_NORMAL);
+
+            reference->load_data(coeff, n);
+            reference->method_bareiss(n);
+            reference->save_data(ref, n);
+
+            if (reference->is_singular()) {
+                continue;
+            }
+
+            for (int i = 0; i < n; i++) {
+                res[i] = ref[i] + ((i + c) % 3 - 1) * 1e-2;
+            }
+
+            solver->load_data(coeff, n);
+
+            int k = solver->method_cg(n, res, 1e-14, 4 * n);
+
+            // no pivots behind a converged solve, get_det and get_cond say so
+            if (k < 0) {
+                fallback++;
+            } else {
+                converged++;
+                iters += k;
+                stale += !(std::isnan(solver->get_det()) && std::isnan(solver->get_cond()));
+            }
+
+            hist[classify(res, ref, n, false)]++;
+        }
+
+        printf("------------------------------- %-13s ----------------- n = %d count = %ld\n", "cg-warm", n, num);
+        printf("%-6s", "method");
+        for (int b = 0; b < ERR_BIN_NUM; b++) {
+            printf("%9s", bin_names[b]);
+        }
+        printf("\n%-6s", "cg");
+        for (int b = 0; b < ERR_BIN_NUM; b++) {
+            printf("%9ld", hist[b]);
+        }
+        printf("\n");
+
+        printf("cg converged %ld in %ld iterations, %ld fell back to gemf, %ld left stale pivots\n",
+               converged, iters, fallback, stale);
+    }
+
+    // get_det against the exact Bareiss determinant and get_cond against
+    // ||A||_1 ||A^-1||_1 with the inverse solved column by column, every
+    // regular system of every corpus kind; a NAN determinant is the method
+    // saying its pivots are unusable, any other must be within 1e-2 and the
+    // condition estimate within DET_COND_LO to DET_COND_HI of the true value
+    static const struct {
+        const char *name;
+        void (*method)(EquationSolver *solver, int n);
+    } pivot_methods[] = {
+        { "gem",  [](EquationSolver *solver, int n) { solver->method_gem(n); } },
+        { "gemf", [](EquationSolver *solver, int n) { double x[6]; solver->method_gem_fused(n, x); } },
+        { "gja",  [](EquationSolver *solver, int n) { solver->method_gja(n); } },
+        { "gja2", [](EquationSolver *solver, int n) { solver->method_gja2(n, 8); } },
+        { "gja3", [](EquationSolver *solver, int n) { solver->method_gja3(n); } },
+        { "dfa",  [](EquationSolver *solver, int n) { solver->method_dfa(n); } },
+        { "dfa2", [](EquationSolver *solver, int n) { solver->method_dfa2(n); } },
+        { "dfa3", [](EquationSolver *solver, int n) { solver->method_dfa3(n); } },
+        { "dfa4", [](EquationSolver *solver, int n) { solver->method_dfa4(n); } },
+        { "dfa5", [](EquationSolver *solver, int n) { solver->method_dfa5(n); } },
+        { "bfa",  [](EquationSolver *solver, int n) { solver->method_bfa(n); } },
+    };
+    const int pivot_num = sizeof(pivot_methods) / sizeof(pivot_methods[0]);
+
+    for (int n : sizes) {
+        long num = max(count / 10, 1L);
+        vector<long> hist(pivot_num * ERR_BIN_NUM, 0);
+        vector<double> cond_lo(pivot_num, HUGE_VAL);
+        vector<double> cond_hi(pivot_num, 0.0);
+        long regular = 0;
+        long det_bad = 0;
+        long cond_bad = 0;
+
+        for (int kind = 0; kind < CORPUS_KIND_NUM; kind++) {
+            Corpus corpus(seed + 4000 + kind * 16 + n);
+
+            for (long c = 0; c < num; c++) {
+                int64_t coeff[7][7] = { 0 };
+
+                corpus.generate(coeff, n, kind);
+
+                reference->load_data(coeff, n);
+                reference->method_bareiss(n);
+
+                if (reference->is_singular()) {
+                    continue;
+                }
+
+                regular++;
+
+                double det = fabs(reference->get_den(0).to_double());
+                double norm = 0.0;
+                double inv_norm = 0.0;
+
+                for (int j = 0; j < n; j++) {
+                    int64_t unit[7][7];
+                    double x[6];
+                    double a = 0.0;
+                    double b = 0.0;
+
+                    memcpy(unit, coeff, sizeof(unit));
+
+                    for (int i = 0; i < n; i++) {
+                        unit[i + 1][n] = (i == j);
+                        a += fabs((double)coeff[i + 1][j]);
+                    }
+
+                    reference->load_data(unit, n);
+                    reference->method_bareiss(n);
+                    reference->save_data(x, n);
+
+                    for (int i = 0; i < n; i++) {
+                        b += fabs(x[i]);
+                    }
+
+                    norm = max(norm, a);
+                    inv_norm = max(inv_norm, b);
+                }
+
+                for (int m = 0; m < pivot_num; m++) {
+                    solver->load_data(coeff, n);
+                    pivot_methods[m].method(solver, n);
+
+                    double d = solver->get_det();
+                    double r = solver->get_cond() / (norm * inv_norm);
+                    double err = fabs(fabs(d) / det - 1.0);
+                    int b;
+
+                    if (std::isnan(d)) {
+                        b = ERR_NAN;
+                    } else if (!(err < 1e0)) {
+                        b = ERR_HUGE;
+                    } else if (err < 1e-12) {
+                        b = ERR_1E12;
+                    } else if (err < 1e-9) {
+                        b = ERR_1E9;
+                    } else if (err < 1e-6) {
+                        b = ERR_1E6;
+                    } else if (err < 1e-3) {
+                        b = ERR_1E3;
+                    } else {
+                        b = ERR_1E0;
+                    }
+
+                    hist[m * ERR_BIN_NUM + b]++;
+                    det_bad += !std::isnan(d) && !(err < 1e-2);
+
+                    if (!std::isnan(r)) {
+                        cond_lo[m] = min(cond_lo[m], r);
+                        cond_hi[m] = max(cond_hi[m], r);
+                        cond_bad += !(r >= DET_COND_LO && r <= DET_COND_HI);
+                    }
+                }
+            }
+        }
+
+        printf("------------------------------- %-13s ----------------- n = %d count = %ld\n", "det-cond", n, regular);
+        printf("%-6s", "method");
+        for (int b = 0; b < ERR_BIN_NUM; b++) {
+            printf("%9s", bin_names[b]);
+        }
+        printf("%12s%12s\n", "cond-lo", "cond-hi");
+
+        for (int m = 0; m < pivot_num; m++) {
+            printf("%-6s", pivot_methods[m].name);
+            for (int b = 0; b < ERR_BIN_NUM; b++) {
+                printf("%9ld", hist[m * ERR_BIN_NUM + b]);
+            }
+            if (cond_hi[m] > 0.0) {
+                printf("%12.3g%12.3g\n", cond_lo[m], cond_hi[m]);
+            } else {
+                printf("%12s%12s\n", "-", "-");
+            }
+        }
+
+        printf("determinants off by 1e-2 or more: %ld, condition estimates out of range: %ld\n", det_bad, cond_bad);
+    }
+
+    // save_data_q after dfa and bfa and save_data_gem_q after gem, every
+    // rounding mode on diagonal systems whose quotients are the table rows
+    static const char *round_methods[3] = { "dfaq", "bfaq", "gemq" };
+    const int round_num = sizeof(round_cases) / sizeof(round_cases[0]);
+    long round_bad[3] = {};
+
+    for (int base = 0; base < round_num; base += 4) {
+        int64_t coeff[7][7] = { 0 };
+
+        for (int i = 0; i < 4; i++) {
+            const RoundCase &rc = round_cases[min(base + i, round_num - 1)];
+
+            coeff[i + 1][i] = rc.d;
+            coeff[i + 1][4] = rc.b;
+        }
+
+        for (int r = ROUND_ZERO; r <= ROUND_HALF_AWAY; r++) {
+            for (int m = 0; m < 3; m++) {
+                int32_t q[6];
+
+                solver->load_data(coeff, 4);
+
+                if (m == 0) {
+                    solver->method_dfa(4);
+                    solver->save_data_q(q, 4, 0, r, -3, 3);
+                } else if (m == 1) {
+                    solver->method_bfa(4);
+                    solver->save_data_q(q, 4, 0, r, -3, 3);
+                } else {
+                    solver->method_gem(4);
+                    solver->save_data_gem_q(q, 4, 0, r, -3, 3);
+                }
+
+                for (int i = 0; i < 4; i++) {
+                    round_bad[m] += (q[i] != round_cases[min(base + i, round_num - 1)].q[r]);
+                }
+            }
+        }
+    }
+
+    // an empty range and a NaN result both give zeros
+    {
+        int64_t coeff[7][7] = { 0 };
+        int32_t q[6];
+
+        for (int i = 0; i < 4; i++) {
+            coeff[i + 1][i] = 2;
+            coeff[i + 1][4] = 3;
+        }
+
+        solver->load_data(coeff, 4);
+        solver->method_dfa(4);
+        solver->save_data_q(q, 4, 0, ROUND_HALF_UP, 3, -3);
+        round_bad[0] += (q[0] | q[1] | q[2] | q[3]) != 0;
+
+        solver->load_data(coeff, 4);
+        solver->method_gem(4);
+        solver->save_data_gem_q(q, 4, 0, ROUND_HALF_UP, 3, -3);
+        round_bad[2] += (q[0] | q[1] | q[2] | q[3]) != 0;
+
+        // no method in between, the zero last row back-substitutes as 0 / 0
+        coeff[4][3] = 0;
+        coeff[4][4] = 0;
+
+        solver->load_data(coeff, 4);
+        solver->save_data_gem_q(q, 4, 0, ROUND_HALF_UP, -3, 3);
+        round_bad[2] += (q[0] | q[1] | q[2] | q[3]) != 0;
+    }
+
+    printf("------------------------------- %-13s ----------------- n = 4 count = %d\n", "rounding", round_num);
+    for (int m = 0; m < 3; m++) {
+        printf("%-6s %ld wrong integer parameters over 4 rounding modes\n", round_methods[m], round_bad[m]);
+    }
+
+    printf("------------------------------- DIGEST ----------------------------------\n");
+    for (int m = 0; m < solver_method_num; m++) {
+        printf("digest %-6s %016" PRIx64 "\n", solver_methods[m].name, digest[m]);
+    }
+
+    for (int s = 0; s < 2; s++) {
+        printf("digest lu%-4d %016" PRIx64 "\n", large[s], large_digest[s]);
+    }
+
+    delete(reference);
+    delete(solver);
+}
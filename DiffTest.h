@@ -0,0 +1,41 @@
+/*
+ * DiffTest.h
+ *
+ *  Created on: 2026-10-19 05:33
+ */
+
+#ifndef __DIFF_TEST__
+#define __DIFF_TEST__
+
+#include <cstdint>
+
+enum {
+    ERR_1E12 = 0,
+    ERR_1E9,
+    ERR_1E6,
+    ERR_1E3,
+    ERR_1E0,
+    ERR_HUGE,
+    ERR_ZERO,           // all zeros returned for a regular system
+    ERR_NAN,
+    ERR_SING_OK,        // singular system, all zeros returned
+    ERR_SING_BAD,       // singular system, something else returned
+    ERR_BIN_NUM
+};
+
+// runs every method against the exact reference solver and collects
+// histograms of the scaled error max|x - r| / max(1, max|r|)
+class DiffTest
+{
+private:
+    uint64_t seed;
+
+    static int classify(const double *res, const double *ref, int n, bool singular);
+
+public:
+    DiffTest(uint64_t seed);
+
+    void run(long count);
+};
+
+#endif // __DIFF_TEST__
@@ -5,10 +5,77 @@
  *      Author: Jack Chen <redchenjs@live.com>
  */
 
+#include <cfloat>
+
+#include "GradAccum.h"
 #include "EquationSolver.h"
+#include "EquationSolverInline.h"
 
 using namespace std;
 
+// file-local ISA clones, each inlines the private kernel it forwards to
+struct EquationSolverKernel {
+    SOLVER_KERNEL static void method_gem(EquationSolver *s, int n)
+    {
+        s->method_gem_kernel(n);
+    }
+
+    SOLVER_KERNEL static void method_gem_fused(EquationSolver *s, int n, double dAffinePara[6])
+    {
+        s->method_gem_fused_kernel(n, dAffinePara);
+    }
+
+    SOLVER_KERNEL static void method_gja(EquationSolver *s, int n)
+    {
+        s->method_gja_kernel(n);
+    }
+
+    SOLVER_KERNEL static void method_gja2(EquationSolver *s, int n, int q)
+    {
+        s->method_gja2_kernel(n, q);
+    }
+
+    SOLVER_KERNEL static void method_gja3(EquationSolver *s, int n)
+    {
+        s->method_gja3_kernel(n);
+    }
+
+    SOLVER_KERNEL static void method_dfa(EquationSolver *s, int n)
+    {
+        s->method_dfa_kernel(n);
+    }
+
+    SOLVER_KERNEL static void method_dfa2(EquationSolver *s, int n)
+    {
+        s->method_dfa2_kernel(n);
+    }
+
+    SOLVER_KERNEL static void method_dfa3(EquationSolver *s, int n)
+    {
+        s->method_dfa3_kernel(n);
+    }
+
+    SOLVER_KERNEL static void method_dfa4(EquationSolver *s, int n)
+    {
+        s->method_dfa4_kernel(n);
+    }
+
+    SOLVER_KERNEL static void method_dfa5(EquationSolver *s, int n)
+    {
+        s->method_dfa5_kernel(n);
+    }
+
+    SOLVER_KERNEL static void method_bfa(EquationSolver *s, int n)
+    {
+        s->method_bfa_kernel(n);
+    }
+
+    SOLVER_KERNEL static int method_cg(EquationSolver *s, int n, double dAffinePara[6], double tol, int iter)
+    {
+        return s->method_cg_kernel(n, dAffinePara, tol, iter);
+    }
+};
+
 #define LOG_COLOR_BLACK   "30"
 #define LOG_COLOR_RED     "31"
 #define LOG_COLOR_GREEN   "32"
@@ -31,6 +98,71 @@ void EquationSolver::set_debug(bool val)
     debug = val;
 }
 
+// lambda added to the diagonal in load_data, turns a positive semi-definite
+// normal matrix into a definite one so zero pivots cannot occur
+void EquationSolver::set_ridge(int64_t val)
+{
+    ridge = val;
+}
+
+// records every print_mat point of one solve in every, 0 turns it off;
+// the per-thread ring is allocated here rather than on the first sample
+void EquationSolver::set_trace(int every)
+{
+    trace_every = every;
+    trace_count = 0;
+
+    if (every != 0) {
+        TraceRing::local();
+    }
+}
+
+// times every load_data -> method -> save_data sequence into the
+// LatencyHist of the calling thread, one timestamp read at each end; the
+// histogram is looked up here once, so call it on the thread that solves
+void EquationSolver::set_latency(bool val)
+{
+    lat_hist = val ? &LatencyHist::local() : nullptr;
+    lat_start = 0;
+}
+
+// called where a solve hands out its result, load_data arms it again
+void EquationSolver::lat_stop(int n)
+{
+    if (lat_start) {
+        lat_hist->record(lat_method, n, lat_now() - lat_start);
+        lat_start = 0;
+    }
+}
+
+void EquationSolver::trace_mat(int type, const char *name, int k, int m, int n, int fmt, const void *T)
+{
+    TraceRecord *rec = TraceRing::local().next();
+
+    rec->seq = trace_count - 1;
+    rec->type = type;
+    rec->fmt = fmt;
+    rec->n = n;
+    rec->k = k;
+    rec->m = m;
+    rec->shifts = 0;
+
+    strncpy(rec->name, name, sizeof(rec->name) - 1);
+    rec->name[sizeof(rec->name) - 1] = 0;
+
+    memcpy(&rec->T, T, (fmt == TRACE_F32) ? sizeof(float[7][7]) : sizeof(int64_t[7][7]));
+
+    // shifts since the last step belong to this one
+    if (type == TRACE_STEP) {
+        rec->shifts = trace_shifts;
+        memcpy(rec->shift, trace_shift, trace_shifts);
+    }
+
+    if (type == TRACE_BEGIN || type == TRACE_STEP) {
+        trace_shifts = 0;
+    }
+}
+
 void EquationSolver::zero_mat(int n)
 {
     for (int p = 0; p < n; p++) {
@@ -39,6 +171,22 @@ void EquationSolver::zero_mat(int n)
     }
 }
 
+// max column sum for the condition estimate
+void EquationSolver::norm_mat(int n)
+{
+    norm = 0.0;
+
+    for (int i = 0; i < n; i++) {
+        double sum = 0.0;
+
+        for (int row = 0; row < n; row++) {
+            sum += abs(C[row][i]);
+        }
+
+        norm = max(norm, sum);
+    }
+}
+
 void EquationSolver::scale_mat(int64_t *_M, int64_t *_D, int64_t *_L, int64_t *_C, uint8_t *_B)
 {
     uint8_t DIFF_BITS = 0;
@@ -66,11 +214,24 @@ void EquationSolver::scale_mat(int64_t *_M, int64_t *_D, int64_t *_L, int64_t *_
         *_L = *_L >> DIFF_BITS;
 
         *_B -= DIFF_BITS;
+
+        // the row is no longer a multiple of the old one, the pivots say nothing
+        piv_valid = false;
+    }
+
+    if (tracing && trace_shifts < (int)sizeof(trace_shift)) {
+        trace_shift[trace_shifts++] = DIFF_BITS;
     }
 }
 
 void EquationSolver::load_mat(int n, int64_t T[7][7])
 {
+    piv_n = n;
+    piv_flip = false;
+    piv_valid = true;
+    piv_exact = false;
+    piv_unit = 1.0;
+
     for (int p = 0; p < n; p++) {
         for (int q = 0; q < n + 1; q++) {
             T[p][q] = (int64_t)C[p][q];
@@ -80,6 +241,12 @@ void EquationSolver::load_mat(int n, int64_t T[7][7])
 
 void EquationSolver::load_mat(int n, double T[7][7])
 {
+    piv_n = n;
+    piv_flip = false;
+    piv_valid = true;
+    piv_exact = false;
+    piv_unit = 1.0;
+
     for (int p = 0; p < n; p++) {
         for (int q = 0; q < n + 1; q++) {
             T[p][q] = (double)C[p][q];
@@ -89,6 +256,12 @@ void EquationSolver::load_mat(int n, double T[7][7])
 
 void EquationSolver::load_mat(int n, float T[7][7])
 {
+    piv_n = n;
+    piv_flip = false;
+    piv_valid = true;
+    piv_exact = false;
+    piv_unit = 1.0;
+
     for (int p = 0; p < n; p++) {
         for (int q = 0; q < n + 1; q++) {
             T[p][q] = (float)C[p][q];
@@ -147,8 +320,13 @@ bool EquationSolver::pivot_mat(int k, int n, int64_t T[7][7])
         }
 
         print_mat('B', k, m, n, T);
+
+        piv_flip = !piv_flip;
     }
 
+    piv[k] = (double)T[k][k];
+    piv_scale[k] = 1.0;
+
     if (T[k][k] == 0) {
         return false;
     }
@@ -180,8 +358,13 @@ bool EquationSolver::pivot_mat(int k, int n, double T[7][7])
         }
 
         print_mat('B', k, m, n, T);
+
+        piv_flip = !piv_flip;
     }
 
+    piv[k] = (double)T[k][k];
+    piv_scale[k] = 1.0;
+
     if (T[k][k] == 0.) {
         return false;
     }
@@ -213,8 +396,13 @@ bool EquationSolver::pivot_mat(int k, int n, float T[7][7])
         }
 
         print_mat('B', k, m, n, T);
+
+        piv_flip = !piv_flip;
     }
 
+    piv[k] = (double)T[k][k];
+    piv_scale[k] = 1.0;
+
     if (T[k][k] == 0.) {
         return false;
     }
@@ -222,8 +410,36 @@ bool EquationSolver::pivot_mat(int k, int n, float T[7][7])
     return true;
 }
 
+// false when a row operation M * D - L * C of step k may leave int64: every
+// multiplier comes from column k and both products stay below the largest
+// of them times the largest entry, so 62 bits for the two together is safe
+bool EquationSolver::bound_mat(int k, int n, const int64_t T[7][7])
+{
+    uint64_t col = 0;
+    uint64_t all = 0;
+
+    for (int i = 0; i < n; i++) {
+        col |= (T[i][k] < 0) ? 0 - (uint64_t)T[i][k] : (uint64_t)T[i][k];
+
+        for (int j = 0; j < n + 1; j++) {
+            all |= (T[i][j] < 0) ? 0 - (uint64_t)T[i][j] : (uint64_t)T[i][j];
+        }
+    }
+
+    int col_bits = col ? 64 - __builtin_clzll(col) : 0;
+    int all_bits = all ? 64 - __builtin_clzll(all) : 0;
+
+    return col_bits + all_bits <= 62;
+}
+
 void EquationSolver::print_mat(const char *str, int n, const int64_t T[7][7])
 {
+    tracing = (trace_every != 0) && (trace_count++ % trace_every == 0);
+
+    if (tracing) {
+        trace_mat(TRACE_BEGIN, str, 0, 0, n, TRACE_I64, T);
+    }
+
     if (debug) {
         printf("------------------------------- %-5s ------------------------------ n = %d\n", str, n);
         for (int p = 0; p < n; p++) {
@@ -241,6 +457,12 @@ void EquationSolver::print_mat(const char *str, int n, const int64_t T[7][7])
 
 void EquationSolver::print_mat(const char *str, int n, const double T[7][7])
 {
+    tracing = (trace_every != 0) && (trace_count++ % trace_every == 0);
+
+    if (tracing) {
+        trace_mat(TRACE_BEGIN, str, 0, 0, n, TRACE_F64, T);
+    }
+
     if (debug) {
         printf("------------------------------- %-5s ------------------------------ n = %d\n", str, n);
         for (int p = 0; p < n; p++) {
@@ -258,6 +480,12 @@ void EquationSolver::print_mat(const char *str, int n, const double T[7][7])
 
 void EquationSolver::print_mat(const char *str, int n, const float T[7][7])
 {
+    tracing = (trace_every != 0) && (trace_count++ % trace_every == 0);
+
+    if (tracing) {
+        trace_mat(TRACE_BEGIN, str, 0, 0, n, TRACE_F32, T);
+    }
+
     if (debug) {
         printf("------------------------------- %-5s ------------------------------ n = %d\n", str, n);
         for (int p = 0; p < n; p++) {
@@ -275,6 +503,12 @@ void EquationSolver::print_mat(const char *str, int n, const float T[7][7])
 
 void EquationSolver::print_mat(char idx, int k, int n, const int64_t T[7][7])
 {
+    if (tracing) {
+        char str[2] = { idx, 0 };
+
+        trace_mat(TRACE_STEP, str, k, 0, n, TRACE_I64, T);
+    }
+
     if (debug) {
         printf("------------------------------- MATRIX %c --------------------- n = %d k = %d\n", idx, n, k);
         for (int p = 0; p < n; p++) {
@@ -292,6 +526,12 @@ void EquationSolver::print_mat(char idx, int k, int n, const int64_t T[7][7])
 
 void EquationSolver::print_mat(char idx, int k, int n, const double T[7][7])
 {
+    if (tracing) {
+        char str[2] = { idx, 0 };
+
+        trace_mat(TRACE_STEP, str, k, 0, n, TRACE_F64, T);
+    }
+
     if (debug) {
         printf("------------------------------- MATRIX %c --------------------- n = %d k = %d\n", idx, n, k);
         for (int p = 0; p < n; p++) {
@@ -309,6 +549,12 @@ void EquationSolver::print_mat(char idx, int k, int n, const double T[7][7])
 
 void EquationSolver::print_mat(char idx, int k, int n, const float T[7][7])
 {
+    if (tracing) {
+        char str[2] = { idx, 0 };
+
+        trace_mat(TRACE_STEP, str, k, 0, n, TRACE_F32, T);
+    }
+
     if (debug) {
         printf("------------------------------- MATRIX %c --------------------- n = %d k = %d\n", idx, n, k);
         for (int p = 0; p < n; p++) {
@@ -326,6 +572,12 @@ void EquationSolver::print_mat(char idx, int k, int n, const float T[7][7])
 
 void EquationSolver::print_mat(char idx, int k, int m, int n, const int64_t T[7][7])
 {
+    if (tracing) {
+        char str[2] = { idx, 0 };
+
+        trace_mat((idx == 'A') ? TRACE_SWAP_A : TRACE_SWAP_B, str, k, m, n, TRACE_I64, T);
+    }
+
     if (debug) {
         printf("------------------------------- MATRIX %c --------------- n = %d k = %d m = %d\n", idx, n, k, m);
         for (int p = 0; p < n; p++) {
@@ -343,6 +595,12 @@ void EquationSolver::print_mat(char idx, int k, int m, int n, const int64_t T[7]
 
 void EquationSolver::print_mat(char idx, int k, int m, int n, const double T[7][7])
 {
+    if (tracing) {
+        char str[2] = { idx, 0 };
+
+        trace_mat((idx == 'A') ? TRACE_SWAP_A : TRACE_SWAP_B, str, k, m, n, TRACE_F64, T);
+    }
+
     if (debug) {
         printf("------------------------------- MATRIX %c --------------- n = %d k = %d m = %d\n", idx, n, k, m);
         for (int p = 0; p < n; p++) {
@@ -360,6 +618,12 @@ void EquationSolver::print_mat(char idx, int k, int m, int n, const double T[7][
 
 void EquationSolver::print_mat(char idx, int k, int m, int n, const float T[7][7])
 {
+    if (tracing) {
+        char str[2] = { idx, 0 };
+
+        trace_mat((idx == 'A') ? TRACE_SWAP_A : TRACE_SWAP_B, str, k, m, n, TRACE_F32, T);
+    }
+
     if (debug) {
         printf("------------------------------- MATRIX %c --------------- n = %d k = %d m = %d\n", idx, n, k, m);
         for (int p = 0; p < n; p++) {
@@ -377,6 +641,12 @@ void EquationSolver::print_mat(char idx, int k, int m, int n, const float T[7][7
 
 void EquationSolver::print_res(int n, const double T[7][7])
 {
+    if (tracing) {
+        trace_mat(TRACE_RESULT, "", 0, 0, n, TRACE_F64, T);
+
+        tracing = false;
+    }
+
     if (debug) {
         printf("------------------------------- RESULT -----------------------------------\n");
         for (int i = 0; i < n; i++) {
@@ -386,11 +656,13 @@ void EquationSolver::print_res(int n, const double T[7][7])
     }
 }
 
-void EquationSolver::method_gem(int n)
+SOLVER_INLINE void EquationSolver::method_gem_kernel(int n)
 {
     bool zero = false;
-    double T[7][7] = { 0.0 };
-    double D[7][7] = { 0.0 };
+    double T[7][7];
+    double D[7][7];
+
+    lat_method = LAT_GEM;
 
     load_mat(n, T);
     print_mat(" GEM ", n, T);
@@ -442,11 +714,57 @@ void EquationSolver::method_gem(int n)
     print_res(n, C);
 }
 
-void EquationSolver::method_gja(int n)
+void EquationSolver::method_gem(int n)
+{
+    EquationSolverKernel::method_gem(this, n);
+}
+
+// forward elimination and back-substitution in one pass, the matrix never
+// goes through C and the result lands in dAffinePara directly
+SOLVER_INLINE void EquationSolver::method_gem_fused_kernel(int n, double dAffinePara[6])
+{
+    double T[7][7];
+
+    lat_method = LAT_GEM_F;
+
+    load_mat(n, T);
+    print_mat("GEM-F", n, T);
+
+    for (int k = 0; k < n; k++) {
+        if (!pivot_mat(k, n, T)) {
+            for (int i = 0; i < n; i++) {
+                dAffinePara[i] = 0;
+            }
+
+            lat_stop(n);
+            return;
+        }
+
+        double M = T[k][k];
+
+        gem_step<1>(k, n, &M, [&](int i, int j, int) -> double & { return T[i][j]; });
+
+        print_mat('T', k, n, T);
+    }
+
+    gem_back<1>(n, [&](int i, int j, int) -> double & { return T[i][j]; },
+                [&](int i, int) -> double & { return dAffinePara[i]; });
+
+    lat_stop(n);
+}
+
+void EquationSolver::method_gem_fused(int n, double dAffinePara[6])
+{
+    EquationSolverKernel::method_gem_fused(this, n, dAffinePara);
+}
+
+SOLVER_INLINE void EquationSolver::method_gja_kernel(int n)
 {
     bool zero = false;
-    double T[7][7] = { 0.0 };
-    double D[7][7] = { 0.0 };
+    double T[7][7];
+    double D[7][7];
+
+    lat_method = LAT_GJA;
 
     load_mat(n, T);
     print_mat(" GJA ", n, T);
@@ -498,12 +816,19 @@ void EquationSolver::method_gja(int n)
     print_res(n, C);
 }
 
-void EquationSolver::method_gja2(int n, int q)
+void EquationSolver::method_gja(int n)
+{
+    EquationSolverKernel::method_gja(this, n);
+}
+
+SOLVER_INLINE void EquationSolver::method_gja2_kernel(int n, int q)
 {
     bool zero = false;
-    int64_t T[7][7] = { 0 };
-    int64_t D[7][7] = { 0 };
-    int64_t F[7][7] = { 0 };
+    int64_t T[7][7];
+    int64_t D[7][7];
+    int64_t F[7][7];
+
+    lat_method = LAT_GJA2;
 
     load_mat(n, T);
     print_mat("GJA-2", n, T);
@@ -515,6 +840,11 @@ void EquationSolver::method_gja2(int n, int q)
         }
     }
 
+    // the multipliers keep q fraction bits, too few for the pivots to give
+    // a determinant or condition estimate
+    piv_valid = false;
+    piv_unit = ldexp(1.0, q);
+
     for (int k = 0; k < n; k++) {
         if (!pivot_mat(k, n, F)) {
             zero = true;
@@ -569,11 +899,18 @@ void EquationSolver::method_gja2(int n, int q)
     print_res(n, C);
 }
 
-void EquationSolver::method_gja3(int n)
+void EquationSolver::method_gja2(int n, int q)
+{
+    EquationSolverKernel::method_gja2(this, n, q);
+}
+
+SOLVER_INLINE void EquationSolver::method_gja3_kernel(int n)
 {
     bool zero = false;
-    float T[7][7] = { 0.0 };
-    float D[7][7] = { 0.0 };
+    float T[7][7];
+    float D[7][7];
+
+    lat_method = LAT_GJA3;
 
     load_mat(n, T);
     print_mat("GJA-3", n, T);
@@ -625,11 +962,18 @@ void EquationSolver::method_gja3(int n)
     print_res(n, C);
 }
 
-void EquationSolver::method_dfa(int n)
+void EquationSolver::method_gja3(int n)
+{
+    EquationSolverKernel::method_gja3(this, n);
+}
+
+SOLVER_INLINE void EquationSolver::method_dfa_kernel(int n)
 {
     bool zero = false;
-    int64_t T[7][7] = { 0 };
-    int64_t D[7][7] = { 0 };
+    int64_t T[7][7];
+    int64_t D[7][7];
+
+    lat_method = LAT_DFA;
 
     load_mat(n, T);
     print_mat(" DFA ", n, T);
@@ -642,6 +986,10 @@ void EquationSolver::method_dfa(int n)
 
         int64_t M = T[k][k];
 
+        piv_valid = piv_valid && bound_mat(k, n, T);
+
+        piv_scale[k] = (double)M;
+
         for (int i = 0; i < n; i++) {
             int64_t L = T[i][k];
 
@@ -681,11 +1029,18 @@ void EquationSolver::method_dfa(int n)
     print_res(n, C);
 }
 
-void EquationSolver::method_dfa2(int n)
+void EquationSolver::method_dfa(int n)
+{
+    EquationSolverKernel::method_dfa(this, n);
+}
+
+SOLVER_INLINE void EquationSolver::method_dfa2_kernel(int n)
 {
     bool zero = false;
-    int64_t T[7][7] = { 0 };
-    int64_t D[7][7] = { 0 };
+    int64_t T[7][7];
+    int64_t D[7][7];
+
+    lat_method = LAT_DFA2;
 
     load_mat(n, T);
     print_mat("DFA-2", n, T);
@@ -699,6 +1054,11 @@ void EquationSolver::method_dfa2(int n)
         int64_t M = T[k][k];
         uint8_t B = (M == 0) ? 0 : (uint8_t)logb(M);
 
+        // rows shifted right are rounded, only an unshifted step keeps the pivots
+        piv_valid = piv_valid && (B == 0) && bound_mat(k, n, T);
+
+        piv_scale[k] = ldexp((double)M, -B);
+
         for (int i = 0; i < n; i++) {
             int64_t L = T[i][k];
 
@@ -723,7 +1083,7 @@ void EquationSolver::method_dfa2(int n)
         }
 
         for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n + 2; j++) {
+            for (int j = 0; j < n + 1; j++) {
                 T[i][j] = D[i][j];
             }
         }
@@ -740,11 +1100,18 @@ void EquationSolver::method_dfa2(int n)
     print_res(n, C);
 }
 
-void EquationSolver::method_dfa3(int n)
+void EquationSolver::method_dfa2(int n)
+{
+    EquationSolverKernel::method_dfa2(this, n);
+}
+
+SOLVER_INLINE void EquationSolver::method_dfa3_kernel(int n)
 {
     bool zero = false;
-    int64_t T[7][7] = { 0 };
-    int64_t D[7][7] = { 0 };
+    int64_t T[7][7];
+    int64_t D[7][7];
+
+    lat_method = LAT_DFA3;
 
     load_mat(n, T);
     print_mat("DFA-3", n, T);
@@ -763,6 +1130,11 @@ void EquationSolver::method_dfa3(int n)
             B++;
         }
 
+        // rows shifted right are rounded, only an unshifted step keeps the pivots
+        piv_valid = piv_valid && (B == 0) && bound_mat(k, n, T);
+
+        piv_scale[k] = ldexp((double)M, -B);
+
         for (int i = 0; i < n; i++) {
             int64_t L = T[i][k];
 
@@ -787,7 +1159,7 @@ void EquationSolver::method_dfa3(int n)
         }
 
         for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n + 2; j++) {
+            for (int j = 0; j < n + 1; j++) {
                 T[i][j] = D[i][j];
             }
         }
@@ -804,11 +1176,18 @@ void EquationSolver::method_dfa3(int n)
     print_res(n, C);
 }
 
-void EquationSolver::method_dfa4(int n)
+void EquationSolver::method_dfa3(int n)
+{
+    EquationSolverKernel::method_dfa3(this, n);
+}
+
+SOLVER_INLINE void EquationSolver::method_dfa4_kernel(int n)
 {
     bool zero = false;
-    int64_t T[7][7] = { 0 };
-    int64_t D[7][7] = { 0 };
+    int64_t T[7][7];
+    int64_t D[7][7];
+
+    lat_method = LAT_DFA4;
 
     load_mat(n, T);
     print_mat("DFA-4", n, T);
@@ -827,6 +1206,11 @@ void EquationSolver::method_dfa4(int n)
             B++;
         }
 
+        // rows shifted right are rounded, only an unshifted step keeps the pivots
+        piv_valid = piv_valid && (B == 0);
+
+        piv_scale[k] = ldexp((double)M, -B);
+
         for (int i = 0; i < n; i++) {
             int64_t L = T[i][k];
 
@@ -853,7 +1237,7 @@ void EquationSolver::method_dfa4(int n)
         }
 
         for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n + 2; j++) {
+            for (int j = 0; j < n + 1; j++) {
                 T[i][j] = D[i][j];
             }
         }
@@ -870,11 +1254,18 @@ void EquationSolver::method_dfa4(int n)
     print_res(n, C);
 }
 
-void EquationSolver::method_dfa5(int n)
+void EquationSolver::method_dfa4(int n)
+{
+    EquationSolverKernel::method_dfa4(this, n);
+}
+
+SOLVER_INLINE void EquationSolver::method_dfa5_kernel(int n)
 {
     bool zero = false;
-    int64_t T[7][7] = { 0 };
-    int64_t D[7][7] = { 0 };
+    int64_t T[7][7];
+    int64_t D[7][7];
+
+    lat_method = LAT_DFA5;
 
     load_mat(n, T);
     print_mat("DFA-5", n, T);
@@ -888,6 +1279,11 @@ void EquationSolver::method_dfa5(int n)
         int64_t M = T[k][k];
         uint8_t B = (M == 0) ? 0 : (uint8_t)logb(M);
 
+        // rows shifted right are rounded, only an unshifted step keeps the pivots
+        piv_valid = piv_valid && (B == 0);
+
+        piv_scale[k] = ldexp((double)M, -B);
+
         for (int i = 0; i < n; i++) {
             int64_t L = T[i][k];
 
@@ -913,7 +1309,7 @@ void EquationSolver::method_dfa5(int n)
         }
 
         for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n + 2; j++) {
+            for (int j = 0; j < n + 1; j++) {
                 T[i][j] = D[i][j];
             }
         }
@@ -930,28 +1326,309 @@ void EquationSolver::method_dfa5(int n)
     print_res(n, C);
 }
 
-void EquationSolver::load_data(const int64_t i64EqualCoeff[7][7], int iParaNum)
+void EquationSolver::method_dfa5(int n)
 {
-    for (int row = 0; row < iParaNum; row++) {
-        for (int i = 0; i < iParaNum + 1; i++) {
-            C[row][i] = (double)i64EqualCoeff[row + 1][i];
+    EquationSolverKernel::method_dfa5(this, n);
+}
+
+SOLVER_INLINE void EquationSolver::method_bfa_kernel(int n)
+{
+    int k = 0;
+    bool zero = false;
+    bool wide = false;
+    int64_t T[7][7];
+    int64_t D[7][7];
+    int64_t P = 1;
+
+    lat_method = LAT_BFA;
+
+    load_mat(n, T);
+    print_mat(" BFA ", n, T);
+
+    for (k = 0; k < n; k++) {
+        if (!pivot_mat(k, n, T)) {
+            zero = true;
+            break;
         }
+
+        int64_t M = T[k][k];
+
+        piv_scale[k] = (double)M / (double)P;
+
+        for (int i = 0; i < n; i++) {
+            int64_t L = T[i][k];
+
+            if (k == i) {
+                // row k is not modified
+                for (int j = 0; j < n + 1; j++) {
+                    D[k][j] = T[k][j];
+                }
+            } else {
+                // make T[i][k] zero, the division by the previous pivot is exact
+                for (int j = 0; j < n + 1; j++) {
+                    __int128 _M = M;
+                    __int128 _D = T[i][j];
+                    __int128 _L = L;
+                    __int128 _C = T[k][j];
+
+                    __int128 Q = (_M * _D - _L * _C) / P;
+
+                    wide |= (Q > INT64_MAX) || (Q < INT64_MIN);
+
+                    D[i][j] = (int64_t)Q;
+                }
+            }
+        }
+
+        if (wide) {
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n + 1; j++) {
+                T[i][j] = D[i][j];
+            }
+        }
+
+        P = M;
+
+        print_mat('T', k, n, T);
     }
+
+    if (!wide) {
+        save_mat(n, T);
+
+        // the last Bareiss pivot is the determinant of the row-swapped matrix
+        if (!zero) {
+            piv_exact = true;
+            piv_det = piv_flip ? -T[n - 1][n - 1] : T[n - 1][n - 1];
+        }
+    } else {
+        // the minors outgrew int64, finish the same recurrence in double
+        double F[7][7];
+        double G[7][7];
+        double PF = (double)P;
+
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n + 1; j++) {
+                F[i][j] = (double)T[i][j];
+            }
+        }
+
+        for (; k < n; k++) {
+            if (!pivot_mat(k, n, F)) {
+                zero = true;
+                break;
+            }
+
+            double M = F[k][k];
+
+            piv_scale[k] = M / PF;
+
+            for (int i = 0; i < n; i++) {
+                double L = F[i][k];
+
+                if (k == i) {
+                    // row k is not modified
+                    for (int j = 0; j < n + 1; j++) {
+                        G[k][j] = F[k][j];
+                    }
+                } else {
+                    // make F[i][k] zero
+                    for (int j = 0; j < n + 1; j++) {
+                        G[i][j] = (M * F[i][j] - L * F[k][j]) / PF;
+                    }
+                }
+            }
+
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < n + 1; j++) {
+                    F[i][j] = G[i][j];
+                }
+            }
+
+            PF = M;
+
+            print_mat('F', k, n, F);
+        }
+
+        save_mat(n, F);
+    }
+
+    if (zero) {
+        zero_mat(n);
+    }
+
+    print_res(n, C);
 }
 
-void EquationSolver::save_data_gem(double dAffinePara[6], int iParaNum)
+void EquationSolver::method_bfa(int n)
+{
+    EquationSolverKernel::method_bfa(this, n);
+}
+
+// Jacobi-preconditioned conjugate gradient on the loaded system, starting
+// from dAffinePara; returns the number of iterations taken to bring the
+// relative residual below tol, 0 when the guess already meets it, or -1
+// after falling back to method_gem_fused when the matrix is not symmetric
+// positive definite or iter runs out, the fallback is timed as gemf; no
+// pivots come out of CG, get_det and get_cond report NAN after it converges
+SOLVER_INLINE int EquationSolver::method_cg_kernel(int n, double dAffinePara[6], double tol, int iter)
 {
-    dAffinePara[iParaNum - 1] = C[iParaNum - 1][iParaNum] / C[iParaNum - 1][iParaNum - 1];
+    double R[6], Z[6], P[6], Q[6];
+    double bb = 0.0, rr = 0.0, rz = 0.0;
+
+    lat_method = LAT_CG;
+
+    // the loaded values are integers, a symmetric system matches exactly
+    for (int i = 0; i < n; i++) {
+        bool spd = (C[i][i] > 0.);
+
+        for (int j = i + 1; j < n; j++) {
+            spd &= (C[i][j] == C[j][i]);
+        }
+
+        if (!spd) {
+            method_gem_fused(n, dAffinePara);
+            return -1;
+        }
+    }
 
-    for (int i = iParaNum - 2; i >= 0; i--) {
+    // the fallback reloads them, a converged solve leaves none
+    piv_n = -1;
+    piv_exact = false;
+
+    // r = b - A x
+    for (int i = 0; i < n; i++) {
         double temp = 0;
 
-        for (int j = i + 1; j < iParaNum; j++) {
+        for (int j = 0; j < n; j++) {
             temp += C[i][j] * dAffinePara[j];
         }
 
-        dAffinePara[i] = (C[i][iParaNum] - temp) / C[i][i];
+        R[i] = C[i][n] - temp;
+        Z[i] = R[i] / C[i][i];
+        P[i] = Z[i];
+
+        bb += C[i][n] * C[i][n];
+        rr += R[i] * R[i];
+        rz += R[i] * Z[i];
     }
+
+    double lim = tol * tol * bb;
+
+    for (int k = 0; k < iter; k++) {
+        if (rr <= lim) {
+            lat_stop(n);
+            return k;
+        }
+
+        double pq = 0.0;
+
+        for (int i = 0; i < n; i++) {
+            double temp = 0;
+
+            for (int j = 0; j < n; j++) {
+                temp += C[i][j] * P[j];
+            }
+
+            Q[i] = temp;
+            pq += P[i] * temp;
+        }
+
+        if (!(pq > 0.)) {
+            break;
+        }
+
+        double alpha = rz / pq;
+        double rz_next = 0.0;
+
+        rr = 0.0;
+
+        for (int i = 0; i < n; i++) {
+            dAffinePara[i] += alpha * P[i];
+            R[i] -= alpha * Q[i];
+            Z[i] = R[i] / C[i][i];
+
+            rr += R[i] * R[i];
+            rz_next += R[i] * Z[i];
+        }
+
+        double beta = rz_next / rz;
+
+        rz = rz_next;
+
+        for (int i = 0; i < n; i++) {
+            P[i] = Z[i] + beta * P[i];
+        }
+    }
+
+    if (rr <= lim) {
+        lat_stop(n);
+        return iter;
+    }
+
+    method_gem_fused(n, dAffinePara);
+
+    return -1;
+}
+
+int EquationSolver::method_cg(int n, double dAffinePara[6], double tol, int iter)
+{
+    return EquationSolverKernel::method_cg(this, n, dAffinePara, tol, iter);
+}
+
+void EquationSolver::load_data(const int64_t i64EqualCoeff[7][7], int iParaNum)
+{
+    if (lat_hist) {
+        lat_start = lat_now();
+    }
+
+    for (int row = 0; row < iParaNum; row++) {
+        for (int i = 0; i < iParaNum + 1; i++) {
+            C[row][i] = (double)ridge_add(i64EqualCoeff[row + 1][i], (i == row) ? ridge : 0);
+        }
+    }
+
+    norm_mat(iParaNum);
+}
+
+// accumulates the normal equations into C without going through a
+// 7x7 int64 array, same values as the encoder's build plus load_data
+void EquationSolver::load_grad(const int32_t *piResi, const int32_t *piGradX, const int32_t *piGradY,
+                               int stride, int width, int height, int iParaNum)
+{
+    if (lat_hist) {
+        lat_start = lat_now();
+    }
+
+    int64_t sum[GRAD_SUM_NUM];
+
+    // no gradient model for this size, an all-zero system solves to zeros
+    // and has a zero norm, whatever iParaNum says
+    if (!grad_accum(piResi, piGradX, piGradY, stride, width, height, iParaNum, sum)) {
+        memset(C, 0x00, sizeof(C));
+        norm_mat(6);
+        return;
+    }
+
+    for (int row = 0; row < iParaNum; row++) {
+        for (int i = 0; i < iParaNum + 1; i++) {
+            int64_t v = (i < row) ? sum[grad_index(i, row, iParaNum)] : sum[grad_index(row, i, iParaNum)];
+
+            C[row][i] = (double)ridge_add(v, (i == row) ? ridge : 0);
+        }
+    }
+
+    norm_mat(iParaNum);
+}
+
+void EquationSolver::save_data_gem(double dAffinePara[6], int iParaNum)
+{
+    gem_back<1>(iParaNum, [&](int i, int j, int) -> double & { return C[i][j]; },
+                [&](int i, int) -> double & { return dAffinePara[i]; });
+
+    lat_stop(iParaNum);
 }
 
 void EquationSolver::save_data(double dAffinePara[6], int iParaNum)
@@ -962,11 +1639,14 @@ void EquationSolver::save_data(double dAffinePara[6], int iParaNum)
                 dAffinePara[i] = 0;
             }
 
+            lat_stop(iParaNum);
             return;
         }
 
         dAffinePara[i] = C[i][iParaNum] / C[i][i];
     }
+
+    lat_stop(iParaNum);
 }
 
 void EquationSolver::save_data(double dAffinePara[6], int iParaNum, int frac)
@@ -993,6 +1673,7 @@ void EquationSolver::save_data(double dAffinePara[6], int iParaNum, int frac)
                     dAffinePara[i] = 0;
                 }
 
+                lat_stop(iParaNum);
                 return;
             }
         } else {
@@ -1003,12 +1684,333 @@ void EquationSolver::save_data(double dAffinePara[6], int iParaNum, int frac)
                     dAffinePara[i] = 0;
                 }
 
+                lat_stop(iParaNum);
                 return;
             }
         }
 
         dAffinePara[i] = quotient / pow(2.0, frac);
     }
+
+    lat_stop(iParaNum);
+}
+
+// truncating num / den; with a shared divisor inv holds 1 / |den| and the
+// quotient comes from one multiply plus a remainder correction
+static inline __int128 div_q(__int128 num, int64_t den, long double inv)
+{
+    bool neg = (num < 0) != (den < 0);
+    unsigned __int128 un = (num < 0) ? -(unsigned __int128)num : (unsigned __int128)num;
+    unsigned __int128 ud = (den < 0) ? -(unsigned __int128)den : (unsigned __int128)den;
+    unsigned __int128 uq = 0;
+
+#if LDBL_MANT_DIG >= 64
+    if (inv != 0 && (un >> 62) < ud) {
+        __int128 q = (__int128)((long double)un * inv);
+        __int128 r = (__int128)un - q * (__int128)ud;
+
+        while (r < 0) {
+            q--;
+            r += ud;
+        }
+        while (r >= (__int128)ud) {
+            q++;
+            r -= ud;
+        }
+
+        uq = (unsigned __int128)q;
+    } else
+#endif
+    if ((un >> 64) == 0) {
+        uq = (uint64_t)un / (uint64_t)ud;
+    } else {
+        uq = un / ud;
+    }
+
+    return neg ? -(__int128)uq : (__int128)uq;
+}
+
+// q and r from a truncating division, r carries the sign of the dividend;
+// only the remainder decides the last bit, no further quotient bits are made
+static inline __int128 round_quot(__int128 q, __int128 r, int64_t den, int round)
+{
+    if (r == 0) {
+        return q;
+    }
+
+    bool neg = (r < 0) != (den < 0);
+    unsigned __int128 ur = (r < 0) ? -(unsigned __int128)r : (unsigned __int128)r;
+    unsigned __int128 ud = (den < 0) ? -(unsigned __int128)den : (unsigned __int128)den;
+
+    switch (round) {
+        case ROUND_FLOOR:
+            return neg ? q - 1 : q;
+        case ROUND_HALF_UP:
+            if (neg) {
+                return (2 * ur > ud) ? q - 1 : q;
+            }
+            return (2 * ur >= ud) ? q + 1 : q;
+        case ROUND_HALF_AWAY:
+            if (2 * ur >= ud) {
+                return neg ? q - 1 : q + 1;
+            }
+            return q;
+        default:
+            return q;
+    }
+}
+
+static inline double round_dbl(double x, int round)
+{
+    switch (round) {
+        case ROUND_FLOOR:
+            return floor(x);
+        case ROUND_HALF_UP:
+            return floor(x + 0.5);
+        case ROUND_HALF_AWAY:
+            return ::round(x);
+        default:
+            return trunc(x);
+    }
+}
+
+// (C[i][n] << frac) / C[i][i] for every unknown, exact in 128 bits and
+// rounded as round asks; an int64 shifted by up to 63 bits still fits, a
+// larger or negative frac fails like a singular system
+bool EquationSolver::save_quot(__int128 quot[6], int iParaNum, int frac, int round)
+{
+    bool shared = true;
+    bool wide = false;
+
+    if (frac < 0 || frac > 63) {
+        return false;
+    }
+
+    for (int i = 0; i < iParaNum; i++) {
+        // compared as a double, the int64 conversion is undefined beyond 2^63
+        if (C[i][i] == 0.0) {
+            return false;
+        }
+
+        shared &= (C[i][i] == C[0][0]);
+        wide |= !(fabs(C[i][i]) < 0x1p63) || !(fabs(C[i][iParaNum]) < 0x1p63);
+    }
+
+    // the wide tail of method_bfa leaves entries beyond int64, divide in double
+    if (wide) {
+        for (int i = 0; i < iParaNum; i++) {
+            double q = round_dbl(ldexp(C[i][iParaNum] / C[i][i], frac), round);
+
+            quot[i] = (__int128)max(-0x1p126, min(0x1p126, q));
+        }
+
+        return true;
+    }
+
+    // one reciprocal serves every unknown when the diagonal is uniform, as after method_bfa
+    long double inv = shared ? 1.0L / fabsl((long double)(int64_t)C[0][0]) : 0.0L;
+
+    for (int i = 0; i < iParaNum; i++) {
+        __int128 dividend = (__int128)(int64_t)C[i][iParaNum] * ((__int128)1 << frac);
+
+        quot[i] = div_q(dividend, (int64_t)C[i][i], inv);
+
+        if (round != ROUND_ZERO) {
+            quot[i] = round_quot(quot[i], dividend - quot[i] * (int64_t)C[i][i], (int64_t)C[i][i], round);
+        }
+    }
+
+    return true;
+}
+
+void EquationSolver::save_data_q(double dAffinePara[6], int iParaNum, int frac)
+{
+    __int128 quot[6];
+
+    if (!save_quot(quot, iParaNum, frac, ROUND_ZERO)) {
+        for (int i = 0; i < iParaNum; i++) {
+            dAffinePara[i] = 0;
+        }
+
+        lat_stop(iParaNum);
+        return;
+    }
+
+    const double scale = ldexp(1.0, -frac);
+
+    for (int i = 0; i < iParaNum; i++) {
+        dAffinePara[i] = (double)quot[i] * scale;
+    }
+
+    lat_stop(iParaNum);
+}
+
+void EquationSolver::save_data_q(int32_t iAffinePara[6], int iParaNum, int frac)
+{
+    save_data_q(iAffinePara, iParaNum, frac, ROUND_ZERO, INT32_MIN, INT32_MAX);
+}
+
+// final integer parameters in units of 2^-frac, rounded once from the exact
+// quotient and clipped to [lo, hi], for the integer methods that leave C
+// diagonal; an empty range gives zeros like a singular system
+void EquationSolver::save_data_q(int32_t iAffinePara[6], int iParaNum, int frac, int round, int32_t lo, int32_t hi)
+{
+    __int128 quot[6];
+
+    if (lo > hi || !save_quot(quot, iParaNum, frac, round)) {
+        for (int i = 0; i < iParaNum; i++) {
+            iAffinePara[i] = 0;
+        }
+
+        lat_stop(iParaNum);
+        return;
+    }
+
+    for (int i = 0; i < iParaNum; i++) {
+        iAffinePara[i] = (int32_t)max((__int128)lo, min((__int128)hi, quot[i]));
+    }
+
+    lat_stop(iParaNum);
+}
+
+// the same for method_gem, whose elimination runs in double: the
+// back-substitution result is scaled, rounded and clipped in one pass; a
+// NaN anywhere in the result gives all zeros instead of clipping to hi
+void EquationSolver::save_data_gem_q(int32_t iAffinePara[6], int iParaNum, int frac, int round, int32_t lo, int32_t hi)
+{
+    double x[6];
+    bool nan = false;
+
+    gem_back<1>(iParaNum, [&](int i, int j, int) -> double & { return C[i][j]; },
+                [&](int i, int) -> double & { return x[i]; });
+
+    for (int i = 0; i < iParaNum; i++) {
+        nan |= std::isnan(x[i]);
+    }
+
+    for (int i = 0; i < iParaNum; i++) {
+        double q = round_dbl(ldexp(x[i], frac), round);
+
+        iAffinePara[i] = (lo > hi || nan) ? 0 : (int32_t)max((double)lo, min((double)hi, q));
+    }
+
+    lat_stop(iParaNum);
+}
+
+// determinant of the loaded matrix from the pivots of the last method,
+// each step scales the rows below by piv_scale so the LU pivot of step k is
+// piv[k] over the product of the earlier scales; NAN when the method wrapped,
+// shifted or rounded its rows
+double EquationSolver::get_det(void)
+{
+    if (piv_n < 0 || !piv_valid) {
+        return NAN;
+    }
+
+    double det = piv_flip ? -1.0 : 1.0;
+    double scale = piv_unit;
+
+    for (int k = 0; k < piv_n; k++) {
+        det *= piv[k] / scale;
+        scale *= piv_scale[k];
+
+        if (det == 0.0) {
+            break;
+        }
+    }
+
+    return det;
+}
+
+// exact determinant, only available after method_bfa kept within int64
+bool EquationSolver::get_det(int64_t *det)
+{
+    if (!piv_exact) {
+        return false;
+    }
+
+    *det = piv_det;
+
+    return true;
+}
+
+// cheap 1-norm condition estimate, ||A||_1 times the sum of the inverse LU
+// pivots, HUGE_VAL when a pivot was zero, NAN where get_det is
+double EquationSolver::get_cond(void)
+{
+    if (piv_n < 0 || !piv_valid) {
+        return NAN;
+    }
+
+    double sum = 0.0;
+    double scale = piv_unit;
+
+    for (int k = 0; k < piv_n; k++) {
+        double u = abs(piv[k] / scale);
+
+        if (u == 0.0) {
+            return HUGE_VAL;
+        }
+
+        sum += 1.0 / u;
+        scale *= piv_scale[k];
+    }
+
+    return norm * sum;
+}
+
+template <typename T>
+void EquationSolver::print_trace(const TraceRecord &rec, const T M[7][7])
+{
+    switch (rec.type) {
+        case TRACE_BEGIN:
+            printf(LOG_BOLD(LOG_COLOR_CYAN) "=============================== solve %" PRIu64 " ===============================\n" LOG_RESET_COLOR, rec.seq);
+            print_mat(rec.name, rec.n, M);
+            break;
+        case TRACE_STEP:
+            print_mat(rec.name[0], rec.k, rec.n, M);
+            if (rec.shifts) {
+                printf(LOG_COLOR(LOG_COLOR_CYAN) "scale_mat shifts:");
+                for (int i = 0; i < rec.shifts; i++) {
+                    printf(" %d", rec.shift[i]);
+                }
+                printf(LOG_RESET_COLOR "\n");
+            }
+            break;
+        case TRACE_SWAP_A:
+        case TRACE_SWAP_B:
+            print_mat(rec.name[0], rec.k, rec.m, rec.n, M);
+            break;
+        case TRACE_RESULT:
+            print_res(rec.n, rec.T.d);
+            break;
+        default:
+            break;
+    }
+}
+
+// renders a recorded point exactly as the debug flag would have
+void EquationSolver::print_trace(const TraceRecord &rec)
+{
+    bool save = debug;
+
+    debug = true;
+
+    switch (rec.fmt) {
+        case TRACE_I64:
+            print_trace(rec, rec.T.i);
+            break;
+        case TRACE_F64:
+            print_trace(rec, rec.T.d);
+            break;
+        case TRACE_F32:
+            print_trace(rec, rec.T.f);
+            break;
+        default:
+            break;
+    }
+
+    debug = save;
 }
 
 void EquationSolver::print_data(double dAffinePara[6], int iParaNum)
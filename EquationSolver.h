@@ -15,13 +15,54 @@
 #include <cinttypes>
 #include <algorithm>
 
+#include "Tracer.h"
+#include "LatencyHist.h"
+#include "SolverKernel.h"
+
+// rounding of the integer outputs of save_data_q and save_data_gem_q
+enum {
+    ROUND_ZERO = 0,     // truncate toward zero
+    ROUND_FLOOR,        // toward minus infinity, as an arithmetic right shift
+    ROUND_HALF_UP,      // nearest, ties toward plus infinity, (x + half) >> s
+    ROUND_HALF_AWAY,    // nearest, ties away from zero
+};
+
 class EquationSolver
 {
 private:
     bool debug = false;
+    int64_t ridge = 0;
     double C[7][7] = { 0.0 };
 
+    // pivots seen by pivot_mat and the factor each step applied to the
+    // other rows, enough to recover the LU pivots of any method; piv_n is
+    // -1 after a converged method_cg, which has no pivots, and piv_valid is
+    // cleared once an integer method may have wrapped or shifted a row
+    int piv_n = 0;
+    bool piv_flip = false;
+    bool piv_valid = false;
+    bool piv_exact = false;
+    int64_t piv_det = 0;
+    double piv_unit = 1.0;
+    double piv[6] = {};
+    double piv_scale[6] = {};
+    double norm = 0.0;
+
+    // sampled binary trace of the print_mat points, see set_trace
+    bool tracing = false;
+    int trace_every = 0;
+    uint64_t trace_count = 0;
+    int trace_shifts = 0;
+    uint8_t trace_shift[48];
+
+    // load->solve->save timing into the histogram of the thread that called
+    // set_latency, null while off
+    LatencyHist *lat_hist = nullptr;
+    int lat_method = LAT_GEM;
+    uint64_t lat_start = 0;
+
     void zero_mat(int n);
+    void norm_mat(int n);
     void scale_mat(int64_t *_M, int64_t *_D, int64_t *_L, int64_t *_C, uint8_t *_B);
 
     void load_mat(int n, int64_t T[7][7]);
@@ -36,6 +77,8 @@ private:
     bool pivot_mat(int k, int n, double T[7][7]);
     bool pivot_mat(int k, int n, float T[7][7]);
 
+    bool bound_mat(int k, int n, const int64_t T[7][7]);
+
     void print_mat(const char *str, int n, const int64_t T[7][7]);
     void print_mat(const char *str, int n, const double T[7][7]);
     void print_mat(const char *str, int n, const float T[7][7]);
@@ -50,18 +93,59 @@ private:
 
     void print_res(int n, const double T[7][7]);
 
+    void trace_mat(int type, const char *name, int k, int m, int n, int fmt, const void *T);
+
+    template <typename T>
+    void print_trace(const TraceRecord &rec, const T M[7][7]);
+
+    void lat_stop(int n);
+
+    bool save_quot(__int128 quot[6], int iParaNum, int frac, int round);
+
+    // method bodies, inlined into the per-ISA clones of EquationSolverKernel
+    friend struct EquationSolverKernel;
+
+    void method_gem_kernel(int n);
+    void method_gem_fused_kernel(int n, double dAffinePara[6]);
+    void method_gja_kernel(int n);
+    void method_gja2_kernel(int n, int q);
+    void method_gja3_kernel(int n);
+    void method_dfa_kernel(int n);
+    void method_dfa2_kernel(int n);
+    void method_dfa3_kernel(int n);
+    void method_dfa4_kernel(int n);
+    void method_dfa5_kernel(int n);
+    void method_bfa_kernel(int n);
+    int method_cg_kernel(int n, double dAffinePara[6], double tol, int iter);
+
 public:
     void set_debug(bool val);
+    void set_ridge(int64_t val);
+    void set_trace(int every);
+    void set_latency(bool val);
 
     void load_data(const int64_t i64EqualCoeff[7][7], int iParaNum);
+    // n = 4 or 6 and inputs below 2^14 in magnitude, see grad_accum
+    void load_grad(const int32_t *piResi, const int32_t *piGradX, const int32_t *piGradY,
+                   int stride, int width, int height, int iParaNum);
 
     void save_data_gem(double dAffinePara[6], int iParaNum);
     void save_data(double dAffinePara[6], int iParaNum);
     void save_data(double dAffinePara[6], int iParaNum, int frac);
+    void save_data_q(double dAffinePara[6], int iParaNum, int frac);
+    void save_data_q(int32_t iAffinePara[6], int iParaNum, int frac);
+    void save_data_q(int32_t iAffinePara[6], int iParaNum, int frac, int round, int32_t lo, int32_t hi);
+    void save_data_gem_q(int32_t iAffinePara[6], int iParaNum, int frac, int round, int32_t lo, int32_t hi);
 
     void print_data(double dAffinePara[6], int iParaNum);
+    void print_trace(const TraceRecord &rec);
+
+    double get_det(void);
+    bool get_det(int64_t *det);
+    double get_cond(void);
 
     void method_gem(int n);
+    void method_gem_fused(int n, double dAffinePara[6]);
     void method_gja(int n);
     void method_gja2(int n, int q);
     void method_gja3(int n);
@@ -70,6 +154,8 @@ public:
     void method_dfa3(int n);
     void method_dfa4(int n);
     void method_dfa5(int n);
+    void method_bfa(int n);
+    int method_cg(int n, double dAffinePara[6], double tol, int iter);
 };
 
 #endif // __EQUATION_SOLVER__
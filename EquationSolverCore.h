@@ -0,0 +1,200 @@
+/*
+ * EquationSolverCore.h
+ *
+ *  Created on: 2026-10-19 05:35
+ */
+
+#ifndef __EQUATION_SOLVER_CORE__
+#define __EQUATION_SOLVER_CORE__
+
+#include <cstdint>
+#include <type_traits>
+
+// constexpr solving path, no printf, no libm, usable for compile-time tables
+
+template <typename T>
+struct core_wide { typedef T type; };
+
+template <>
+struct core_wide<int32_t> { typedef int64_t type; };
+
+template <>
+struct core_wide<int64_t> { typedef __int128 type; };
+
+template <typename T>
+struct CoreMat {
+    bool zero = false;
+    bool wide = false;
+    T C[7][7] = {};
+    double F[7][7] = {};    // the double tail once the minors outgrow T
+};
+
+struct CoreResult {
+    bool zero = false;
+    bool wide = false;      // finished in double, not exact
+    double x[6] = {};
+};
+
+template <typename T>
+constexpr T core_abs(T v)
+{
+    return (v < 0) ? -v : v;
+}
+
+template <typename T>
+constexpr CoreMat<T> core_load(const int64_t i64EqualCoeff[7][7], int iParaNum)
+{
+    CoreMat<T> m;
+
+    for (int row = 0; row < iParaNum; row++) {
+        for (int i = 0; i < iParaNum + 1; i++) {
+            m.C[row][i] = (T)i64EqualCoeff[row + 1][i];
+        }
+    }
+
+    return m;
+}
+
+template <typename T>
+constexpr bool core_pivot(int k, int n, T C[7][7])
+{
+    // find column max
+    int m = k;
+    T t = core_abs(C[k][k]);
+
+    for (int i = k + 1; i < n; i++) {
+        if (core_abs(C[i][k]) > t) {
+            t = core_abs(C[i][k]);
+            m = i;
+        }
+    }
+
+    // swap rows k and m
+    if (m != k) {
+        for (int j = 0; j < n + 1; j++) {
+            T s = C[k][j];
+            C[k][j] = C[m][j];
+            C[m][j] = s;
+        }
+    }
+
+    return C[k][k] != 0;
+}
+
+// fraction-free Gauss-Jordan elimination, exact for integer T as long as
+// the minors fit in T; beyond that the wide flag is set and the same
+// recurrence finishes in double, as method_bfa does
+template <typename T>
+constexpr CoreMat<T> core_bfa(CoreMat<T> m, int n)
+{
+    typedef typename core_wide<T>::type W;
+
+    static_assert(!std::is_integral<T>::value || sizeof(W) > sizeof(T), "no wider type to check the minors in");
+
+    T P = 1;
+    T D[7][7] = {};
+    int k = 0;
+
+    for (k = 0; k < n; k++) {
+        if (!core_pivot(k, n, m.C)) {
+            m.zero = true;
+            return m;
+        }
+
+        T M = m.C[k][k];
+
+        for (int i = 0; i < n; i++) {
+            T L = m.C[i][k];
+
+            // make C[i][k] zero, row k is not modified
+            for (int j = 0; j < n + 1; j++) {
+                W Q = (i == k) ? (W)m.C[k][j] : ((W)M * m.C[i][j] - (W)L * m.C[k][j]) / P;
+
+                if ((W)(T)Q != Q) {
+                    m.wide = true;
+                }
+
+                D[i][j] = (T)Q;
+            }
+        }
+
+        // step k starts over in double from the untouched matrix
+        if (m.wide) {
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n + 1; j++) {
+                m.C[i][j] = D[i][j];
+            }
+        }
+
+        P = M;
+    }
+
+    if (!m.wide) {
+        return m;
+    }
+
+    double PF = (double)P;
+
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n + 1; j++) {
+            m.F[i][j] = (double)m.C[i][j];
+        }
+    }
+
+    for (; k < n; k++) {
+        if (!core_pivot(k, n, m.F)) {
+            m.zero = true;
+            return m;
+        }
+
+        double M = m.F[k][k];
+
+        for (int i = 0; i < n; i++) {
+            if (i == k) {
+                continue;
+            }
+
+            double L = m.F[i][k];
+
+            for (int j = 0; j < n + 1; j++) {
+                m.F[i][j] = (M * m.F[i][j] - L * m.F[k][j]) / PF;
+            }
+        }
+
+        PF = M;
+    }
+
+    return m;
+}
+
+template <typename T>
+constexpr CoreResult core_save(const CoreMat<T> &m, int iParaNum)
+{
+    CoreResult res;
+
+    res.zero = m.zero;
+    res.wide = m.wide;
+
+    for (int i = 0; i < iParaNum; i++) {
+        if (m.zero) {
+            res.x[i] = 0.0;
+        } else if (m.wide) {
+            res.x[i] = m.F[i][iParaNum] / m.F[i][i];
+        } else {
+            res.x[i] = (double)m.C[i][iParaNum] / (double)m.C[i][i];
+        }
+    }
+
+    return res;
+}
+
+template <typename T>
+constexpr CoreResult core_solve(const int64_t i64EqualCoeff[7][7], int iParaNum)
+{
+    return core_save(core_bfa(core_load<T>(i64EqualCoeff, iParaNum), iParaNum), iParaNum);
+}
+
+#endif // __EQUATION_SOLVER_CORE__
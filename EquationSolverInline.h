@@ -0,0 +1,284 @@
+/*
+ * EquationSolverInline.h
+ *
+ *  Created on: 2026-10-19 05:42
+ */
+
+#ifndef __EQUATION_SOLVER_INLINE__
+#define __EQUATION_SOLVER_INLINE__
+
+#include <cmath>
+#include <cstdint>
+
+// header-only fixed-size kernels that the caller can inline, no member state
+// and no load_data/save_data round-trip; results are bit-identical to
+// load_data -> method_gem -> save_data_gem and
+// load_data -> method_dfa -> save_data(frac) for coefficients below 2^53,
+// ridge matches set_ridge
+
+// coefficient plus ridge, saturated at the int64 range instead of wrapping
+inline int64_t ridge_add(int64_t v, int64_t ridge)
+{
+    int64_t s;
+
+    if (__builtin_add_overflow(v, ridge, &s)) {
+        return (ridge < 0) ? INT64_MIN : INT64_MAX;
+    }
+
+    return s;
+}
+
+template <typename T, int N>
+inline bool inline_pivot(int k, T (&A)[N][N + 1])
+{
+    // find column max
+    int m = k;
+    T t = (A[k][k] < 0) ? -A[k][k] : A[k][k];
+
+    for (int i = k + 1; i < N; i++) {
+        T a = (A[i][k] < 0) ? -A[i][k] : A[i][k];
+
+        if (a > t) {
+            t = a;
+            m = i;
+        }
+    }
+
+    // swap rows k and m
+    if (m != k) {
+        for (int j = 0; j < N + 1; j++) {
+            T s = A[k][j];
+            A[k][j] = A[m][j];
+            A[m][j] = s;
+        }
+    }
+
+    return A[k][k] != 0;
+}
+
+// one GEM step shared by inline_gem, method_gem_fused and
+// BatchSolver::solve_gem_fused: clear column k below the pivot row and scale
+// that row to a unit pivot, across W lanes; at(i, j, l) is entry (i, j) of
+// lane l and M[l] its pivot after the row swap
+template <int W, typename At>
+inline void gem_step(int k, int n, const double M[W], At at)
+{
+    // make A[i][k] zero
+    for (int i = k + 1; i < n; i++) {
+        double L[W];
+
+        for (int l = 0; l < W; l++) {
+            L[l] = at(i, k, l);
+        }
+
+        for (int j = k; j < n + 1; j++) {
+            for (int l = 0; l < W; l++) {
+                at(i, j, l) = at(i, j, l) - (L[l] / M[l]) * at(k, j, l);
+            }
+        }
+    }
+
+    // make A[k][k] one
+    for (int j = k; j < n + 1; j++) {
+        for (int l = 0; l < W; l++) {
+            at(k, j, l) = at(k, j, l) / M[l];
+        }
+    }
+}
+
+// back-substitution after gem_step, unknown i of lane l goes to x(i, l)
+template <int W, typename At, typename X>
+inline void gem_back(int n, At at, X x)
+{
+    for (int l = 0; l < W; l++) {
+        x(n - 1, l) = at(n - 1, n, l) / at(n - 1, n - 1, l);
+    }
+
+    for (int i = n - 2; i >= 0; i--) {
+        double temp[W];
+
+        for (int l = 0; l < W; l++) {
+            temp[l] = 0;
+        }
+
+        for (int j = i + 1; j < n; j++) {
+            for (int l = 0; l < W; l++) {
+                temp[l] += at(i, j, l) * x(j, l);
+            }
+        }
+
+        for (int l = 0; l < W; l++) {
+            x(i, l) = (at(i, n, l) - temp[l]) / at(i, i, l);
+        }
+    }
+}
+
+template <int N>
+inline bool inline_gem(const int64_t i64EqualCoeff[7][7], double dAffinePara[6], int64_t ridge = 0)
+{
+    static_assert(N >= 1 && N <= 6, "at most 6 parameters");
+
+    double A[N][N + 1];
+
+    for (int p = 0; p < N; p++) {
+        for (int q = 0; q < N + 1; q++) {
+            A[p][q] = (double)ridge_add(i64EqualCoeff[p + 1][q], (p == q) ? ridge : 0);
+        }
+    }
+
+    for (int k = 0; k < N; k++) {
+        if (!inline_pivot(k, A)) {
+            for (int i = 0; i < N; i++) {
+                dAffinePara[i] = 0;
+            }
+
+            return false;
+        }
+
+        double M = A[k][k];
+
+        gem_step<1>(k, N, &M, [&](int i, int j, int) -> double & { return A[i][j]; });
+    }
+
+    gem_back<1>(N, [&](int i, int j, int) -> double & { return A[i][j]; },
+                [&](int i, int) -> double & { return dAffinePara[i]; });
+
+    return true;
+}
+
+template <int N>
+inline bool inline_dfa(const int64_t i64EqualCoeff[7][7], double dAffinePara[6], int frac, int64_t ridge = 0)
+{
+    static_assert(N >= 1 && N <= 6, "at most 6 parameters");
+
+    int64_t A[N][N + 1];
+
+    for (int p = 0; p < N; p++) {
+        for (int q = 0; q < N + 1; q++) {
+            A[p][q] = ridge_add(i64EqualCoeff[p + 1][q], (p == q) ? ridge : 0);
+        }
+    }
+
+    for (int k = 0; k < N; k++) {
+        if (!inline_pivot(k, A)) {
+            for (int i = 0; i < N; i++) {
+                dAffinePara[i] = 0;
+            }
+
+            return false;
+        }
+
+        int64_t M = A[k][k];
+
+        // make A[i][k] zero, wrapping like the member kernel
+        for (int i = 0; i < N; i++) {
+            if (i == k) {
+                continue;
+            }
+
+            int64_t L = A[i][k];
+
+            for (int j = 0; j < N + 1; j++) {
+                A[i][j] = (int64_t)((uint64_t)M * (uint64_t)A[i][j] - (uint64_t)L * (uint64_t)A[k][j]);
+            }
+        }
+    }
+
+    for (int i = 0; i < N; i++) {
+        // rounded through double as save_mat does
+        int64_t dividend  = (int64_t)(double)A[i][N];
+        int64_t divisor   = (int64_t)(double)A[i][i];
+        int64_t quotient = 0;
+
+        uint8_t D_BITS = (dividend == 0) ? 0 : (uint8_t)logb(dividend);
+        uint8_t F_BITS = (frac == 0) ? 0 : (uint8_t)logb(frac);
+
+        if (D_BITS + F_BITS >= 64) {
+            divisor = divisor >> frac;
+        } else {
+            dividend = dividend << frac;
+        }
+
+        if (divisor == 0) {
+            for (int i = 0; i < N; i++) {
+                dAffinePara[i] = 0;
+            }
+
+            return false;
+        }
+
+        quotient = dividend / divisor;
+
+        dAffinePara[i] = quotient / pow(2.0, frac);
+    }
+
+    return true;
+}
+
+enum {
+    ADJ_OK   = 0,
+    ADJ_ZERO = 1,   // determinant zero, parameters written as zeros
+    ADJ_WIDE = 2,   // a coefficient exceeds 2^30, nothing solved, parameters written as zeros
+};
+
+// determinant of four of the five columns from the 2x2 minors of rows
+// 0-1 (S) and rows 2-3 (T), Laplace expansion along the row pairs
+inline __int128 inline_det4(const int64_t S[5][5], const int64_t T[5][5], int i, int j, int k, int l)
+{
+    return (__int128)S[i][j] * T[k][l] - (__int128)S[i][k] * T[j][l] + (__int128)S[i][l] * T[j][k]
+         + (__int128)S[j][k] * T[i][l] - (__int128)S[j][l] * T[i][k] + (__int128)S[k][l] * T[i][j];
+}
+
+// closed-form 4-parameter solve by Cramer's rule, no pivoting and no
+// data-dependent branches past the range check; exact up to the final
+// division while every coefficient stays below 2^30 in magnitude, so the
+// minors fit int64 and the determinants __int128; anything wider would
+// overflow the minors and returns ADJ_WIDE before a single product
+inline int inline_adj4(const int64_t i64EqualCoeff[7][7], double dAffinePara[6])
+{
+    const int64_t (*A)[7] = &i64EqualCoeff[1];
+    int64_t S[5][5], T[5][5];
+    uint64_t wide = 0;
+
+    for (int p = 0; p < 4; p++) {
+        for (int q = 0; q < 5; q++) {
+            wide |= ((uint64_t)A[p][q] + (1ULL << 30)) >> 31;
+        }
+    }
+
+    if (wide) {
+        for (int i = 0; i < 4; i++) {
+            dAffinePara[i] = 0;
+        }
+
+        return ADJ_WIDE;
+    }
+
+    for (int i = 0; i < 5; i++) {
+        for (int j = i + 1; j < 5; j++) {
+            S[i][j] = A[0][i] * A[1][j] - A[0][j] * A[1][i];
+            T[i][j] = A[2][i] * A[3][j] - A[2][j] * A[3][i];
+        }
+    }
+
+    // column 4 is the right-hand side, moving it to position j costs
+    // 3 - j column swaps
+    __int128 det = inline_det4(S, T, 0, 1, 2, 3);
+    __int128 num[4] = {
+        -inline_det4(S, T, 1, 2, 3, 4),
+         inline_det4(S, T, 0, 2, 3, 4),
+        -inline_det4(S, T, 0, 1, 3, 4),
+         inline_det4(S, T, 0, 1, 2, 4),
+    };
+
+    bool zero = (det == 0);
+    double div = zero ? 1.0 : (double)det;
+
+    for (int i = 0; i < 4; i++) {
+        dAffinePara[i] = zero ? 0.0 : (double)num[i] / div;
+    }
+
+    return zero ? ADJ_ZERO : ADJ_OK;
+}
+
+#endif // __EQUATION_SOLVER_INLINE__
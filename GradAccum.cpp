@@ -0,0 +1,185 @@
+/*
+ * GradAccum.cpp
+ *
+ *  Created on: 2026-10-19 06:08
+ */
+
+#include <algorithm>
+
+#include "GradAccum.h"
+#include "SolverKernel.h"
+
+using namespace std;
+
+enum {
+    MOM_XX = 0,
+    MOM_XY,
+    MOM_YY,
+    MOM_XR,
+    MOM_YR,
+    MOM_NUM
+};
+
+// weighted moments by monomial: 1, cx, cy, cx^2, cx*cy, cy^2
+enum {
+    MONO_1 = 0,
+    MONO_X,
+    MONO_Y,
+    MONO_XX,
+    MONO_XY,
+    MONO_YY,
+    MONO_NUM
+};
+
+// each 6-parameter coefficient is one of gx, gy times 1, cx or cy, so
+// every sum is a single weighted moment
+static void grad_combine6(const int64_t U[MONO_NUM][MOM_NUM], int64_t sum[GRAD_SUM_NUM])
+{
+    int64_t *S = sum;
+
+    *S++ = U[MONO_1][MOM_XX];
+    *S++ = U[MONO_X][MOM_XX];
+    *S++ = U[MONO_1][MOM_XY];
+    *S++ = U[MONO_X][MOM_XY];
+    *S++ = U[MONO_Y][MOM_XX];
+    *S++ = U[MONO_Y][MOM_XY];
+
+    *S++ = U[MONO_XX][MOM_XX];
+    *S++ = U[MONO_X][MOM_XY];
+    *S++ = U[MONO_XX][MOM_XY];
+    *S++ = U[MONO_XY][MOM_XX];
+    *S++ = U[MONO_XY][MOM_XY];
+
+    *S++ = U[MONO_1][MOM_YY];
+    *S++ = U[MONO_X][MOM_YY];
+    *S++ = U[MONO_Y][MOM_XY];
+    *S++ = U[MONO_Y][MOM_YY];
+
+    *S++ = U[MONO_XX][MOM_YY];
+    *S++ = U[MONO_XY][MOM_XY];
+    *S++ = U[MONO_XY][MOM_YY];
+
+    *S++ = U[MONO_YY][MOM_XX];
+    *S++ = U[MONO_YY][MOM_XY];
+
+    *S++ = U[MONO_YY][MOM_YY];
+
+    *S++ = U[MONO_1][MOM_XR] * 8;
+    *S++ = U[MONO_X][MOM_XR] * 8;
+    *S++ = U[MONO_1][MOM_YR] * 8;
+    *S++ = U[MONO_X][MOM_YR] * 8;
+    *S++ = U[MONO_Y][MOM_XR] * 8;
+    *S++ = U[MONO_Y][MOM_YR] * 8;
+}
+
+// 4-parameter coefficients gx, cx * gx + cy * gy, gy, cy * gx - cx * gy
+static void grad_combine4(const int64_t U[MONO_NUM][MOM_NUM], int64_t sum[GRAD_SUM_NUM])
+{
+    int64_t *S = sum;
+
+    *S++ = U[MONO_1][MOM_XX];
+    *S++ = U[MONO_X][MOM_XX] + U[MONO_Y][MOM_XY];
+    *S++ = U[MONO_1][MOM_XY];
+    *S++ = U[MONO_Y][MOM_XX] - U[MONO_X][MOM_XY];
+
+    *S++ = U[MONO_XX][MOM_XX] + 2 * U[MONO_XY][MOM_XY] + U[MONO_YY][MOM_YY];
+    *S++ = U[MONO_X][MOM_XY] + U[MONO_Y][MOM_YY];
+    *S++ = U[MONO_XY][MOM_XX] - U[MONO_XX][MOM_XY] + U[MONO_YY][MOM_XY] - U[MONO_XY][MOM_YY];
+
+    *S++ = U[MONO_1][MOM_YY];
+    *S++ = U[MONO_Y][MOM_XY] - U[MONO_X][MOM_YY];
+
+    *S++ = U[MONO_YY][MOM_XX] - 2 * U[MONO_XY][MOM_XY] + U[MONO_XX][MOM_YY];
+
+    *S++ = U[MONO_1][MOM_XR] * 8;
+    *S++ = (U[MONO_X][MOM_XR] + U[MONO_Y][MOM_YR]) * 8;
+    *S++ = U[MONO_1][MOM_YR] * 8;
+    *S++ = (U[MONO_Y][MOM_XR] - U[MONO_X][MOM_YR]) * 8;
+}
+
+SOLVER_KERNEL static void grad_accum_kernel(const int32_t *piResi, const int32_t *piGradX, const int32_t *piGradY,
+                                             int stride, int width, int height, int iParaNum, int64_t sum[GRAD_SUM_NUM])
+{
+    int32_t M[MOM_NUM][GRAD_MAX_WIDTH];
+    int64_t U[MONO_NUM][MOM_NUM] = {};
+    int n = iParaNum;
+
+    for (int y0 = 0; y0 < height; y0 += 4) {
+        int64_t cy = y0 + 2;
+        int y1 = min(y0 + 4, height);
+        int64_t V[3][MOM_NUM] = {};
+
+        for (int x0 = 0; x0 < width; x0 += GRAD_MAX_WIDTH) {
+            int w = min(width - x0, GRAD_MAX_WIDTH);
+
+            for (int m = 0; m < MOM_NUM; m++) {
+                for (int x = 0; x < w; x++) {
+                    M[m][x] = 0;
+                }
+            }
+
+            // per-column moments over the four rows of the band, 32-bit
+            // multiply-add that vectorizes on every ISA level
+            for (int y = y0; y < y1; y++) {
+                const int32_t *gx = piGradX + (size_t)y * stride + x0;
+                const int32_t *gy = piGradY + (size_t)y * stride + x0;
+                const int32_t *rs = piResi + (size_t)y * stride + x0;
+
+                for (int x = 0; x < w; x++) {
+                    M[MOM_XX][x] += gx[x] * gx[x];
+                    M[MOM_XY][x] += gx[x] * gy[x];
+                    M[MOM_YY][x] += gy[x] * gy[x];
+                    M[MOM_XR][x] += gx[x] * rs[x];
+                    M[MOM_YR][x] += gy[x] * rs[x];
+                }
+            }
+
+            // cx is constant over each 4x4 sub-block, weight its moments
+            // by 1, cx and cx^2
+            for (int g = 0; g < w; g += 4) {
+                int64_t cx = x0 + g + 2;
+
+                for (int m = 0; m < MOM_NUM; m++) {
+                    int64_t t = 0;
+
+                    for (int x = g; x < min(g + 4, w); x++) {
+                        t += M[m][x];
+                    }
+
+                    V[0][m] += t;
+                    V[1][m] += t * cx;
+                    V[2][m] += t * cx * cx;
+                }
+            }
+        }
+
+        // cy is constant over the band
+        for (int m = 0; m < MOM_NUM; m++) {
+            U[MONO_1][m]  += V[0][m];
+            U[MONO_X][m]  += V[1][m];
+            U[MONO_Y][m]  += V[0][m] * cy;
+            U[MONO_XX][m] += V[2][m];
+            U[MONO_XY][m] += V[1][m] * cy;
+            U[MONO_YY][m] += V[0][m] * cy * cy;
+        }
+    }
+
+    if (n == 6) {
+        grad_combine6(U, sum);
+    } else {
+        grad_combine4(U, sum);
+    }
+}
+
+bool grad_accum(const int32_t *piResi, const int32_t *piGradX, const int32_t *piGradY,
+                int stride, int width, int height, int iParaNum, int64_t sum[GRAD_SUM_NUM])
+{
+    if (iParaNum != 4 && iParaNum != 6) {
+        fill(sum, sum + GRAD_SUM_NUM, 0);
+        return false;
+    }
+
+    grad_accum_kernel(piResi, piGradX, piGradY, stride, width, height, iParaNum, sum);
+
+    return true;
+}
@@ -0,0 +1,31 @@
+/*
+ * GradAccum.h
+ *
+ *  Created on: 2026-10-19 06:08
+ */
+
+#ifndef __GRAD_ACCUM__
+#define __GRAD_ACCUM__
+
+#include <cstdint>
+
+#define GRAD_MAX_WIDTH  128
+#define GRAD_SUM_NUM    (6 * 7 / 2 + 6)
+
+// position of C[p][q], p <= q, in the packed upper triangle, the
+// right-hand side C[p][n] follows the triangle at grad_index(p, n, n)
+inline int grad_index(int p, int q, int n)
+{
+    return (q == n) ? n * (n + 1) / 2 + p : p * n - p * (p - 1) / 2 + (q - p);
+}
+
+// normal equations of the affine gradient search straight from the
+// residual and gradient planes, 4x4 sub-block centers as in the encoder;
+// gradients and residuals must stay below 2^14 in magnitude so the
+// per-column moments of a 4-row band fit 32 bits, larger inputs wrap and
+// give wrong sums; only the 4- and 6-parameter models exist, any other
+// iParaNum zeroes sum and returns false
+bool grad_accum(const int32_t *piResi, const int32_t *piGradX, const int32_t *piGradY,
+                int stride, int width, int height, int iParaNum, int64_t sum[GRAD_SUM_NUM]);
+
+#endif // __GRAD_ACCUM__
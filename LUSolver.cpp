@@ -0,0 +1,182 @@
+/*
+ * LUSolver.cpp
+ *
+ *  Created on: 2026-10-19 06:04
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "LUSolver.h"
+
+using namespace std;
+
+// iParaNum rows of iParaNum + 1 coefficients, right-hand side last, rows
+// stride elements apart
+void LUSolver::load_data(const int64_t *i64EqualCoeff, int iParaNum, int stride)
+{
+    n = iParaNum;
+    ld = (n + 1 + 7) & ~7;
+    zero = false;
+
+    A.resize((size_t)n * ld);
+
+    for (int row = 0; row < n; row++) {
+        for (int i = 0; i < n + 1; i++) {
+            this->row(row)[i] = (double)i64EqualCoeff[(size_t)row * stride + i];
+        }
+    }
+}
+
+void LUSolver::load_data(const double *dEqualCoeff, int iParaNum, int stride)
+{
+    n = iParaNum;
+    ld = (n + 1 + 7) & ~7;
+    zero = false;
+
+    A.resize((size_t)n * ld);
+
+    for (int row = 0; row < n; row++) {
+        for (int i = 0; i < n + 1; i++) {
+            this->row(row)[i] = dEqualCoeff[(size_t)row * stride + i];
+        }
+    }
+}
+
+// unblocked elimination of columns k0 .. k0 + nb - 1, the multipliers stay
+// below the diagonal for the trailing update
+bool LUSolver::panel(int k0, int nb)
+{
+    for (int k = k0; k < k0 + nb; k++) {
+        // find column max
+        int m = k;
+        double t = abs(row(k)[k]);
+
+        for (int i = k + 1; i < n; i++) {
+            if (abs(row(i)[k]) > t) {
+                t = abs(row(i)[k]);
+                m = i;
+            }
+        }
+
+        if (t == 0.) {
+            return false;
+        }
+
+        // swap rows k and m, whole rows so the right-hand side follows
+        if (m != k) {
+            swap_ranges(row(k), row(k) + n + 1, row(m));
+        }
+
+        double M = row(k)[k];
+
+        for (int i = k + 1; i < n; i++) {
+            double *r = row(i);
+            double L = r[k] / M;
+
+            r[k] = L;
+
+            for (int j = k + 1; j < k0 + nb; j++) {
+                r[j] = r[j] - L * row(k)[j];
+            }
+        }
+    }
+
+    return true;
+}
+
+// U12 = L11^-1 A12, then A22 -= L21 U12 in column tiles so a tile of U12
+// stays in cache while every row below streams past it
+void LUSolver::update(int k0, int nb)
+{
+    int k1 = k0 + nb;
+
+    for (int k = k0; k < k1; k++) {
+        for (int i = k + 1; i < k1; i++) {
+            double *r = row(i);
+            const double *u = row(k);
+            double L = r[k];
+
+            for (int j = k1; j < n + 1; j++) {
+                r[j] = r[j] - L * u[j];
+            }
+        }
+    }
+
+    for (int j0 = k1; j0 < n + 1; j0 += LU_TILE) {
+        int j1 = min(j0 + LU_TILE, n + 1);
+
+        for (int i = k1; i < n; i++) {
+            double *r = row(i);
+            int k = k0;
+
+            // four rows of U12 per pass over r, subtracted in k order so the
+            // rounding matches the unblocked loop
+            for (; k + 4 <= k1; k += 4) {
+                const double *u0 = row(k + 0);
+                const double *u1 = row(k + 1);
+                const double *u2 = row(k + 2);
+                const double *u3 = row(k + 3);
+                double L0 = r[k + 0];
+                double L1 = r[k + 1];
+                double L2 = r[k + 2];
+                double L3 = r[k + 3];
+
+                for (int j = j0; j < j1; j++) {
+                    r[j] = r[j] - L0 * u0[j] - L1 * u1[j] - L2 * u2[j] - L3 * u3[j];
+                }
+            }
+
+            for (; k < k1; k++) {
+                const double *u = row(k);
+                double L = r[k];
+
+                for (int j = j0; j < j1; j++) {
+                    r[j] = r[j] - L * u[j];
+                }
+            }
+        }
+    }
+}
+
+void LUSolver::method_lu(void)
+{
+    for (int k0 = 0; k0 < n; k0 += LU_BLOCK) {
+        int nb = min(LU_BLOCK, n - k0);
+
+        if (!panel(k0, nb)) {
+            zero = true;
+            return;
+        }
+
+        update(k0, nb);
+    }
+}
+
+bool LUSolver::is_singular(void) const
+{
+    return zero;
+}
+
+// back-substitution on U, dAffinePara holds iParaNum values
+void LUSolver::save_data(double *dAffinePara)
+{
+    if (zero) {
+        for (int i = 0; i < n; i++) {
+            dAffinePara[i] = 0;
+        }
+
+        return;
+    }
+
+    for (int i = n - 1; i >= 0; i--) {
+        const double *r = row(i);
+        double temp = 0;
+
+        for (int j = i + 1; j < n; j++) {
+            temp += r[j] * dAffinePara[j];
+        }
+
+        dAffinePara[i] = (r[n] - temp) / r[i];
+    }
+}
@@ -0,0 +1,44 @@
+/*
+ * LUSolver.h
+ *
+ *  Created on: 2026-10-19 06:04
+ */
+
+#ifndef __LU_SOLVER__
+#define __LU_SOLVER__
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#define LU_BLOCK   32
+#define LU_TILE    256
+
+// dynamically sized solver for systems beyond the 6 parameters of
+// EquationSolver, blocked right-looking LU with partial pivoting on the
+// augmented matrix; like method_gem a zero pivot gives all-zero parameters
+class LUSolver
+{
+private:
+    int n = 0;
+    int ld = 0;
+    bool zero = false;
+    std::vector<double> A;
+
+    double *row(int i) { return &A[(size_t)i * ld]; }
+
+    bool panel(int k0, int nb);
+    void update(int k0, int nb);
+
+public:
+    void load_data(const int64_t *i64EqualCoeff, int iParaNum, int stride);
+    void load_data(const double *dEqualCoeff, int iParaNum, int stride);
+
+    void method_lu(void);
+
+    bool is_singular(void) const;
+
+    void save_data(double *dAffinePara);
+};
+
+#endif // __LU_SOLVER__
@@ -0,0 +1,277 @@
+/*
+ * LatencyHist.cpp
+ *
+ *  Created on: 2026-10-19 06:26
+ */
+
+#include <cmath>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <cinttypes>
+#include <algorithm>
+
+#include "LatencyHist.h"
+
+using namespace std;
+
+// live histograms plus the counts of threads that already exited
+struct LatencyState {
+    mutex lock;
+    vector<LatencyHist *> live;
+    vector<uint64_t> retired[LAT_METHOD_NUM][6];
+    FILE *dump_fp = nullptr;
+};
+
+static LatencyState &lat_state(void)
+{
+    static LatencyState state;
+
+    return state;
+}
+
+LatencyHist::LatencyHist(void)
+{
+    for (int m = 0; m < LAT_METHOD_NUM; m++) {
+        for (int n = 0; n < 6; n++) {
+            bucket[m][n].store(nullptr, memory_order_relaxed);
+        }
+    }
+
+    LatencyState &state = lat_state();
+    lock_guard<mutex> guard(state.lock);
+
+    state.live.push_back(this);
+}
+
+LatencyHist::~LatencyHist(void)
+{
+    LatencyState &state = lat_state();
+    lock_guard<mutex> guard(state.lock);
+
+    state.live.erase(find(state.live.begin(), state.live.end(), this));
+
+    // keep the counts of an exiting thread for later reads
+    for (int m = 0; m < LAT_METHOD_NUM; m++) {
+        for (int n = 0; n < 6; n++) {
+            atomic<uint64_t> *b = bucket[m][n].load(memory_order_relaxed);
+
+            if (!b) {
+                continue;
+            }
+
+            vector<uint64_t> &r = state.retired[m][n];
+
+            r.resize(LAT_BUCKETS, 0);
+
+            for (int i = 0; i < LAT_BUCKETS; i++) {
+                r[i] += b[i].load(memory_order_relaxed);
+            }
+
+            delete[](b);
+        }
+    }
+}
+
+int LatencyHist::index(uint64_t ticks)
+{
+    if (ticks < (1ULL << LAT_SUB_BITS)) {
+        return (int)ticks;
+    }
+
+    int e = min(63 - __builtin_clzll(ticks), LAT_EXP_MAX);
+    int m = (ticks >> (e - LAT_SUB_BITS)) & ((1 << LAT_SUB_BITS) - 1);
+
+    // clamp everything beyond the last power of two into its top bucket
+    if (ticks >> (LAT_EXP_MAX + 1)) {
+        m = (1 << LAT_SUB_BITS) - 1;
+    }
+
+    return ((e - LAT_SUB_BITS + 1) << LAT_SUB_BITS) + m;
+}
+
+uint64_t LatencyHist::upper(int idx)
+{
+    if (idx < (1 << LAT_SUB_BITS)) {
+        return idx;
+    }
+
+    int e = (idx >> LAT_SUB_BITS) + LAT_SUB_BITS - 1;
+    int m = idx & ((1 << LAT_SUB_BITS) - 1);
+
+    return (((uint64_t)((1 << LAT_SUB_BITS) + m + 1)) << (e - LAT_SUB_BITS)) - 1;
+}
+
+// the owning thread is the only writer, a relaxed load and store is enough
+// and keeps the increment free of a locked instruction
+void LatencyHist::record(int method, int n, uint64_t ticks)
+{
+    if (n < 1 || n > 6) {
+        return;
+    }
+
+    atomic<uint64_t> *b = bucket[method][n - 1].load(memory_order_relaxed);
+
+    if (!b) {
+        b = new atomic<uint64_t>[LAT_BUCKETS]();
+        bucket[method][n - 1].store(b, memory_order_release);
+    }
+
+    atomic<uint64_t> &c = b[index(ticks)];
+
+    c.store(c.load(memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+const char *LatencyHist::method_name(int method)
+{
+    static const char *names[LAT_METHOD_NUM] = {
+        "gem", "gemf", "gja", "gja2", "gja3", "dfa", "dfa2", "dfa3", "dfa4", "dfa5", "bfa", "cg"
+    };
+
+    return names[method];
+}
+
+// timestamp rate, measured once against the steady clock
+double LatencyHist::ticks_per_ns(void)
+{
+    static const double rate = []() {
+        auto t0 = chrono::steady_clock::now();
+        uint64_t s = lat_now();
+
+        this_thread::sleep_for(chrono::milliseconds(20));
+
+        uint64_t e = lat_now();
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count();
+
+        return (double)(e - s) / ns;
+    }();
+
+    return rate;
+}
+
+// caller holds the state lock
+void LatencyHist::merge(int method, int n, uint64_t *sum)
+{
+    LatencyState &state = lat_state();
+    vector<uint64_t> &r = state.retired[method][n - 1];
+
+    for (int i = 0; i < LAT_BUCKETS; i++) {
+        sum[i] = r.empty() ? 0 : r[i];
+    }
+
+    for (LatencyHist *h : state.live) {
+        atomic<uint64_t> *b = h->bucket[method][n - 1].load(memory_order_acquire);
+
+        if (!b) {
+            continue;
+        }
+
+        for (int i = 0; i < LAT_BUCKETS; i++) {
+            sum[i] += b[i].load(memory_order_relaxed);
+        }
+    }
+}
+
+LatencyStat LatencyHist::stat(int method, int n)
+{
+    static const double quant[3] = { 0.5, 0.99, 0.999 };
+
+    LatencyStat st = {};
+    vector<uint64_t> sum(LAT_BUCKETS);
+
+    if (n < 1 || n > 6) {
+        return st;
+    }
+
+    {
+        LatencyState &state = lat_state();
+        lock_guard<mutex> guard(state.lock);
+
+        merge(method, n, sum.data());
+    }
+
+    for (int i = 0; i < LAT_BUCKETS; i++) {
+        st.count += sum[i];
+    }
+
+    if (st.count == 0) {
+        return st;
+    }
+
+    double rate = ticks_per_ns();
+    double *out[3] = { &st.p50, &st.p99, &st.p999 };
+    uint64_t seen = 0;
+    int q = 0;
+
+    for (int i = 0; i < LAT_BUCKETS; i++) {
+        if (sum[i] == 0) {
+            continue;
+        }
+
+        seen += sum[i];
+
+        // the smallest value with at least quant of the samples at or below it
+        while (q < 3 && seen >= (uint64_t)ceil(quant[q] * st.count)) {
+            *out[q++] = upper(i) / rate;
+        }
+
+        st.max = upper(i) / rate;
+    }
+
+    return st;
+}
+
+void LatencyHist::dump(FILE *fp)
+{
+    fprintf(fp, "------------------------------- LATENCY ---------------------------------- ns\n");
+    fprintf(fp, "%-6s %2s%12s%10s%10s%10s%10s\n", "method", "n", "count", "p50", "p99", "p999", "max");
+
+    for (int m = 0; m < LAT_METHOD_NUM; m++) {
+        for (int n = 1; n < 7; n++) {
+            LatencyStat st = stat(m, n);
+
+            if (st.count == 0) {
+                continue;
+            }
+
+            fprintf(fp, "%-6s %2d%12" PRIu64 "%10.0f%10.0f%10.0f%10.0f\n",
+                    method_name(m), n, st.count, st.p50, st.p99, st.p999, st.max);
+        }
+    }
+}
+
+// the exiting thread's histogram is destroyed before atexit handlers run,
+// so its counts are already in the retired totals by then
+void LatencyHist::dump_at_exit(FILE *fp)
+{
+    LatencyState &state = lat_state();
+
+    bool first;
+
+    {
+        lock_guard<mutex> guard(state.lock);
+
+        first = (state.dump_fp == nullptr);
+        state.dump_fp = fp;
+    }
+
+    if (!first) {
+        return;
+    }
+
+    // calibrated up front so the exit path does not sleep
+    ticks_per_ns();
+
+    atexit([]() {
+        dump(lat_state().dump_fp);
+    });
+}
+
+LatencyHist &LatencyHist::local(void)
+{
+    static thread_local LatencyHist hist;
+
+    return hist;
+}
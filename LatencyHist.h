@@ -0,0 +1,93 @@
+/*
+ * LatencyHist.h
+ *
+ *  Created on: 2026-10-19 06:26
+ */
+
+#ifndef __LATENCY_HIST__
+#define __LATENCY_HIST__
+
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <ctime>
+#endif
+
+// log-linear buckets: values below 2^LAT_SUB_BITS are exact, above that
+// every power of two is split into 2^LAT_SUB_BITS buckets, about 3% apart
+#define LAT_SUB_BITS 5
+#define LAT_EXP_MAX  40
+#define LAT_BUCKETS  ((LAT_EXP_MAX - LAT_SUB_BITS + 2) << LAT_SUB_BITS)
+
+enum {
+    LAT_GEM = 0,
+    LAT_GEM_F,
+    LAT_GJA,
+    LAT_GJA2,
+    LAT_GJA3,
+    LAT_DFA,
+    LAT_DFA2,
+    LAT_DFA3,
+    LAT_DFA4,
+    LAT_DFA5,
+    LAT_BFA,
+    LAT_CG,
+    LAT_METHOD_NUM
+};
+
+// percentiles in ns, each the upper bound of the bucket holding that rank
+struct LatencyStat {
+    uint64_t count;
+    double p50;
+    double p99;
+    double p999;
+    double max;
+};
+
+// raw timestamp, tsc ticks on x86, ns elsewhere
+inline uint64_t lat_now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+// per-thread load->solve->save latency histograms for every method and n;
+// only the owning thread writes its buckets, readers merge all threads
+// under a lock that recording never takes
+class LatencyHist
+{
+private:
+    std::atomic<std::atomic<uint64_t> *> bucket[LAT_METHOD_NUM][6];
+
+    static int index(uint64_t ticks);
+    static uint64_t upper(int idx);
+    static void merge(int method, int n, uint64_t *sum);
+
+public:
+    LatencyHist(void);
+    ~LatencyHist(void);
+
+    void record(int method, int n, uint64_t ticks);
+
+    static const char *method_name(int method);
+    static double ticks_per_ns(void);
+
+    static LatencyStat stat(int method, int n);
+    static void dump(FILE *fp);
+    static void dump_at_exit(FILE *fp);
+
+    static LatencyHist &local(void);
+};
+
+#endif // __LATENCY_HIST__
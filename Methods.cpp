@@ -0,0 +1,246 @@
+/*
+ * Methods.cpp
+ *
+ *  Created on: 2026-10-19 05:33
+ */
+
+#include "Methods.h"
+#include "LUSolver.h"
+#include "BatchSolver.h"
+#include "EquationSolverInline.h"
+
+static void solve_gem(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    solver->load_data(i64EqualCoeff, iParaNum);
+    solver->method_gem(iParaNum);
+    solver->save_data_gem(dAffinePara, iParaNum);
+}
+
+static void solve_gja(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    solver->load_data(i64EqualCoeff, iParaNum);
+    solver->method_gja(iParaNum);
+    solver->save_data(dAffinePara, iParaNum);
+}
+
+static void solve_gja2(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    solver->load_data(i64EqualCoeff, iParaNum);
+    solver->method_gja2(iParaNum, 8);
+    solver->save_data(dAffinePara, iParaNum, 8);
+}
+
+static void solve_gja3(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    solver->load_data(i64EqualCoeff, iParaNum);
+    solver->method_gja3(iParaNum);
+    solver->save_data(dAffinePara, iParaNum);
+}
+
+static void solve_dfa(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    solver->load_data(i64EqualCoeff, iParaNum);
+    solver->method_dfa(iParaNum);
+    solver->save_data(dAffinePara, iParaNum, 8);
+}
+
+static void solve_dfa2(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    solver->load_data(i64EqualCoeff, iParaNum);
+    solver->method_dfa2(iParaNum);
+    solver->save_data(dAffinePara, iParaNum, 8);
+}
+
+static void solve_dfa3(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    solver->load_data(i64EqualCoeff, iParaNum);
+    solver->method_dfa3(iParaNum);
+    solver->save_data(dAffinePara, iParaNum, 8);
+}
+
+static void solve_dfa4(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    solver->load_data(i64EqualCoeff, iParaNum);
+    solver->method_dfa4(iParaNum);
+    solver->save_data(dAffinePara, iParaNum, 8);
+}
+
+static void solve_dfa5(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    solver->load_data(i64EqualCoeff, iParaNum);
+    solver->method_dfa5(iParaNum);
+    solver->save_data(dAffinePara, iParaNum, 8);
+}
+
+static void solve_bfa(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    solver->load_data(i64EqualCoeff, iParaNum);
+    solver->method_bfa(iParaNum);
+    solver->save_data(dAffinePara, iParaNum);
+}
+
+static void solve_gem_b(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    static BatchSolver batch;
+    int status;
+
+    batch.solve_gem(1, (const int64_t (*)[7][7])i64EqualCoeff, iParaNum, (double (*)[6])dAffinePara, &status);
+}
+
+static void solve_dfa_b(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    static BatchSolver batch;
+    int status;
+
+    batch.solve_dfa(1, (const int64_t (*)[7][7])i64EqualCoeff, iParaNum, (double (*)[6])dAffinePara, &status, 8);
+}
+
+static void solve_gem_i(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    if (iParaNum == 4) {
+        inline_gem<4>(i64EqualCoeff, dAffinePara);
+    } else if (iParaNum == 6) {
+        inline_gem<6>(i64EqualCoeff, dAffinePara);
+    } else {
+        solve_gem(solver, i64EqualCoeff, iParaNum, dAffinePara);
+    }
+}
+
+static void solve_dfa_i(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    if (iParaNum == 4) {
+        inline_dfa<4>(i64EqualCoeff, dAffinePara, 8);
+    } else if (iParaNum == 6) {
+        inline_dfa<6>(i64EqualCoeff, dAffinePara, 8);
+    } else {
+        solve_dfa(solver, i64EqualCoeff, iParaNum, dAffinePara);
+    }
+}
+
+static void solve_dfa_q(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    solver->load_data(i64EqualCoeff, iParaNum);
+    solver->method_dfa(iParaNum);
+    solver->save_data_q(dAffinePara, iParaNum, 8);
+}
+
+static void solve_bfa_q(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    solver->load_data(i64EqualCoeff, iParaNum);
+    solver->method_bfa(iParaNum);
+    solver->save_data_q(dAffinePara, iParaNum, 8);
+}
+
+static void solve_gem_f(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    solver->load_data(i64EqualCoeff, iParaNum);
+    solver->method_gem_fused(iParaNum, dAffinePara);
+}
+
+static void solve_gem_bf(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    static BatchSolver batch;
+    int status;
+
+    batch.solve_gem_fused(1, (const int64_t (*)[7][7])i64EqualCoeff, iParaNum, (double (*)[6])dAffinePara, &status);
+}
+
+static void solve_lu(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    static LUSolver lu;
+
+    lu.load_data(&i64EqualCoeff[1][0], iParaNum, 7);
+    lu.method_lu();
+    lu.save_data(dAffinePara);
+}
+
+// cold start, the registry has no previous solution to offer
+static void solve_cg(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    for (int i = 0; i < iParaNum; i++) {
+        dAffinePara[i] = 0;
+    }
+
+    solver->load_data(i64EqualCoeff, iParaNum);
+    solver->method_cg(iParaNum, dAffinePara, 1e-12, 2 * iParaNum);
+}
+
+#define VERIFY_RIDGE 4096
+
+// the diagonal comes in lowered by the ridge that load_data adds back, so
+// the reference solution of the unmodified system still applies
+static void ridge_lower(int64_t T[7][7], const int64_t i64EqualCoeff[7][7], int iParaNum)
+{
+    for (int row = 0; row < 7; row++) {
+        for (int i = 0; i < 7; i++) {
+            T[row][i] = i64EqualCoeff[row][i];
+        }
+    }
+
+    for (int row = 0; row < iParaNum; row++) {
+        T[row + 1][row] -= VERIFY_RIDGE;
+    }
+}
+
+static void solve_gem_r(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    int64_t T[7][7];
+
+    ridge_lower(T, i64EqualCoeff, iParaNum);
+
+    solver->set_ridge(VERIFY_RIDGE);
+    solve_gem(solver, T, iParaNum, dAffinePara);
+    solver->set_ridge(0);
+}
+
+static void solve_dfa_ir(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    int64_t T[7][7];
+
+    ridge_lower(T, i64EqualCoeff, iParaNum);
+
+    if (iParaNum == 4) {
+        inline_dfa<4>(T, dAffinePara, 8, VERIFY_RIDGE);
+    } else if (iParaNum == 6) {
+        inline_dfa<6>(T, dAffinePara, 8, VERIFY_RIDGE);
+    } else {
+        solver->set_ridge(VERIFY_RIDGE);
+        solve_dfa(solver, T, iParaNum, dAffinePara);
+        solver->set_ridge(0);
+    }
+}
+
+static void solve_adj4(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6])
+{
+    if (iParaNum != 4 || (inline_adj4(i64EqualCoeff, dAffinePara) & ADJ_WIDE)) {
+        solve_gem(solver, i64EqualCoeff, iParaNum, dAffinePara);
+    }
+}
+
+const SolverMethod solver_methods[] = {
+    { "gem",  solve_gem  },
+    { "gja",  solve_gja  },
+    { "gja2", solve_gja2 },
+    { "gja3", solve_gja3 },
+    { "dfa",  solve_dfa  },
+    { "dfa2", solve_dfa2 },
+    { "dfa3", solve_dfa3 },
+    { "dfa4", solve_dfa4 },
+    { "dfa5", solve_dfa5 },
+    { "bfa",  solve_bfa  },
+    { "gemb", solve_gem_b },
+    { "dfab", solve_dfa_b },
+    { "gemi", solve_gem_i },
+    { "dfai", solve_dfa_i },
+    { "dfaq", solve_dfa_q },
+    { "bfaq", solve_bfa_q },
+    { "gemf", solve_gem_f },
+    { "gembf", solve_gem_bf },
+    { "lu",   solve_lu   },
+    { "cg",   solve_cg   },
+    { "adj4", solve_adj4 },
+    { "gemr", solve_gem_r },
+    { "dfair", solve_dfa_ir },
+};
+
+const int solver_method_num = sizeof(solver_methods) / sizeof(solver_methods[0]);
@@ -0,0 +1,21 @@
+/*
+ * Methods.h
+ *
+ *  Created on: 2026-10-19 05:33
+ */
+
+#ifndef __METHODS__
+#define __METHODS__
+
+#include "EquationSolver.h"
+
+// one load_data -> method_* -> save_data sequence, as the encoder calls it
+struct SolverMethod {
+    const char *name;
+    void (*solve)(EquationSolver *solver, const int64_t i64EqualCoeff[7][7], int iParaNum, double dAffinePara[6]);
+};
+
+extern const SolverMethod solver_methods[];
+extern const int solver_method_num;
+
+#endif // __METHODS__
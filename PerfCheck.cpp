@@ -0,0 +1,329 @@
+/*
+ * PerfCheck.cpp
+ *
+ *  Created on: 2026-10-19 06:01
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <cstdio>
+#include <cinttypes>
+#include <chrono>
+
+#include "Corpus.h"
+#include "Methods.h"
+#include "PerfCheck.h"
+#include "ReferenceSolver.h"
+
+using namespace std;
+
+#define PERF_ROUNDS 21
+#define PERF_REF    "ref"
+
+// fixed work timed right before every method, so a check can cancel out the
+// speed of the machine at that moment; a frozen elimination without
+// pivoting, the same mix of loads, divides and multiply-subtracts as the
+// methods but sharing no code with them, so it never moves with a change.
+// The low byte of each coefficient on a dominant diagonal keeps every value
+// normal, divide latency depends on the operands; kept out of line on its
+// own cache lines, otherwise its speed follows the rest of the link
+__attribute__((noinline, aligned(64))) static double perf_ref(const int64_t *coeff, long count, int n)
+{
+    double x = 0.0;
+
+    if (n < 1 || n > 6) {
+        return x;
+    }
+
+    for (long c = 0; c < count; c++) {
+        const int64_t (*T)[7] = (const int64_t (*)[7])&coeff[c * 49];
+        double A[6][7];
+
+        for (int p = 0; p < n; p++) {
+            for (int q = 0; q < n + 1; q++) {
+                A[p][q] = (double)(T[p + 1][q] & 0xff) + ((p == q) ? 4096.0 : 0.0);
+            }
+        }
+
+        for (int k = 0; k < n; k++) {
+            double M = A[k][k];
+
+            for (int i = k + 1; i < n; i++) {
+                double L = A[i][k] / M;
+
+                for (int j = k; j < n + 1; j++) {
+                    A[i][j] -= L * A[k][j];
+                }
+            }
+        }
+
+        x += A[n - 1][n];
+    }
+
+    return x;
+}
+
+PerfCheck::PerfCheck(uint64_t seed, long count) : seed(seed), count(count)
+{
+}
+
+void PerfCheck::measure(vector<PerfRecord> &recs)
+{
+    static const int sizes[] = { 4, 6 };
+
+    EquationSolver *solver = new EquationSolver();
+    ReferenceSolver *reference = new ReferenceSolver();
+
+    for (int n : sizes) {
+        vector<int64_t> coeff(count * 49);
+        vector<double> ref(count * 6);
+        vector<bool> singular(count);
+        Corpus corpus(seed + n);
+
+        for (long c = 0; c < count; c++) {
+            int64_t (*T)[7] = (int64_t (*)[7])&coeff[c * 49];
+
+            corpus.generate(T, n, c % CORPUS_KIND_NUM);
+
+            reference->load_data(T, n);
+            reference->method_bareiss(n);
+            reference->save_data(&ref[c * 6], n);
+
+            singular[c] = reference->is_singular();
+        }
+
+        PerfRecord ref_rec = { PERF_REF, n, HUGE_VAL, 0xcbf29ce484222325ULL, 0.0, 1.0 };
+        double x = perf_ref(coeff.data(), count, n);
+
+        const uint8_t *q = (const uint8_t *)&x;
+        for (size_t b = 0; b < sizeof(double); b++) {
+            ref_rec.digest = (ref_rec.digest ^ q[b]) * 0x100000001b3ULL;
+        }
+
+        recs.push_back(ref_rec);
+
+        for (int m = 0; m < solver_method_num; m++) {
+            PerfRecord rec = { solver_methods[m].name, n, HUGE_VAL, 0xcbf29ce484222325ULL, 0.0, 0.0 };
+            double res[6];
+
+            // accuracy and digest in one untimed pass
+            for (long c = 0; c < count; c++) {
+                double err = 0.0;
+                double mag = 1.0;
+
+                solver_methods[m].solve(solver, (int64_t (*)[7])&coeff[c * 49], n, res);
+
+                const uint8_t *p = (const uint8_t *)res;
+                for (size_t b = 0; b < sizeof(double) * n; b++) {
+                    rec.digest = (rec.digest ^ p[b]) * 0x100000001b3ULL;
+                }
+
+                if (singular[c]) {
+                    continue;
+                }
+
+                for (int i = 0; i < n; i++) {
+                    err = max(err, fabs(res[i] - ref[c * 6 + i]));
+                    mag = max(mag, fabs(ref[c * 6 + i]));
+                }
+
+                // nan compares false, keep it visible
+                rec.err = (err / mag > rec.err || std::isnan(err)) ? err / mag : rec.err;
+            }
+
+            recs.push_back(rec);
+        }
+
+        // round-robin over the methods so drift in clock speed hits all of
+        // them alike, the fastest round is the least disturbed one; the ref
+        // run right before each method sees the same machine state, the
+        // median of their ratios over the rounds shrugs off bursts
+        PerfRecord &ref_best = recs[recs.size() - solver_method_num - 1];
+        vector<double> rel(solver_method_num * PERF_ROUNDS);
+
+        for (int r = 0; r < PERF_ROUNDS; r++) {
+            for (int m = 0; m < solver_method_num; m++) {
+                PerfRecord &rec = recs[recs.size() - solver_method_num + m];
+                double res[6];
+
+                auto r0 = chrono::steady_clock::now();
+                volatile double sink = perf_ref(coeff.data(), count, n);
+                auto t0 = chrono::steady_clock::now();
+
+                (void)sink;
+
+                for (long c = 0; c < count; c++) {
+                    solver_methods[m].solve(solver, (int64_t (*)[7])&coeff[c * 49], n, res);
+                }
+
+                auto t1 = chrono::steady_clock::now();
+
+                double ns_ref = chrono::duration<double, nano>(t0 - r0).count() / count;
+                double ns = chrono::duration<double, nano>(t1 - t0).count() / count;
+
+                ref_best.ns = min(ref_best.ns, ns_ref);
+                rec.ns = min(rec.ns, ns);
+                rel[m * PERF_ROUNDS + r] = ns / ns_ref;
+            }
+        }
+
+        for (int m = 0; m < solver_method_num; m++) {
+            double *v = &rel[m * PERF_ROUNDS];
+
+            nth_element(v, v + PERF_ROUNDS / 2, v + PERF_ROUNDS);
+            recs[recs.size() - solver_method_num + m].rel = v[PERF_ROUNDS / 2];
+        }
+    }
+
+    delete(reference);
+    delete(solver);
+}
+
+bool PerfCheck::load(const char *path, vector<PerfRecord> &recs)
+{
+    FILE *fp = fopen(path, "r");
+    char line[256];
+
+    if (fp == NULL) {
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        char name[32];
+        PerfRecord rec;
+
+        if (line[0] == '#') {
+            continue;
+        }
+
+        // files written before the ref column compare raw times
+        rec.rel = 0.0;
+
+        if (sscanf(line, "%31s %d %lf %" SCNx64 " %lf %lf", name, &rec.n, &rec.ns, &rec.digest, &rec.err, &rec.rel) >= 5) {
+            rec.name = name;
+            recs.push_back(rec);
+        }
+    }
+
+    fclose(fp);
+
+    return true;
+}
+
+bool PerfCheck::save(const char *path, const vector<PerfRecord> &recs)
+{
+    FILE *fp = fopen(path, "w");
+
+    if (fp == NULL) {
+        return false;
+    }
+
+    fprintf(fp, "# method n ns/solve digest max-err ns/ref, written by perf-baseline\n");
+
+    for (const PerfRecord &rec : recs) {
+        fprintf(fp, "%-6s %d %.1f %016" PRIx64 " %.6e %.4f\n", rec.name.c_str(), rec.n, rec.ns, rec.digest, rec.err, rec.rel);
+    }
+
+    fclose(fp);
+
+    return true;
+}
+
+static const PerfRecord *perf_find(const vector<PerfRecord> &recs, const string &name, int n)
+{
+    for (const PerfRecord &rec : recs) {
+        if (rec.name == name && rec.n == n) {
+            return &rec;
+        }
+    }
+
+    return NULL;
+}
+
+// larger scaled error than the baseline beyond its printed precision, or a
+// nan where there was none
+static bool perf_worse(double err, double base)
+{
+    if (std::isnan(err)) {
+        return !std::isnan(base);
+    }
+
+    return err > base * (1.0 + 1e-6) + 1e-300;
+}
+
+// slack is the allowed slowdown in percent; every time is taken relative to
+// the ref runs next to it, so a baseline from a calmer moment or a faster
+// clock does not read as a regression
+int PerfCheck::check(const char *path, double slack)
+{
+    vector<PerfRecord> base, recs;
+    int fail = 0;
+
+    if (!load(path, base)) {
+        fprintf(stderr, "perf-check: cannot read %s\n", path);
+        return 2;
+    }
+
+    measure(recs);
+
+    printf("------------------------------- PERF-CHECK ------------------------------- slack = %.0f%%\n", slack);
+    printf("%-6s %2s %10s %10s %8s %12s  %s\n", "method", "n", "ns", "base", "ratio", "max-err", "status");
+
+    for (const PerfRecord &rec : recs) {
+        const PerfRecord *ref = perf_find(base, rec.name, rec.n);
+        const char *status = "ok";
+
+        if (ref == NULL) {
+            printf("%-6s %2d %10.1f %10s %8s %12.3e  %s\n", rec.name.c_str(), rec.n, rec.ns, "-", "-", rec.err, "new");
+            continue;
+        }
+
+        // a baseline without the ref column compares raw times
+        double ratio = (ref->rel > 0.0) ? rec.rel / ref->rel : rec.ns / ref->ns;
+
+        // every method is bit-exact, so any changed bit fails; the error
+        // against the reference tells a loss of accuracy apart from a change
+        // that kept it, the baseline holds it to 7 digits
+        if (perf_worse(rec.err, ref->err)) {
+            status = "LESS ACCURATE";
+            fail++;
+        } else if (rec.digest != ref->digest) {
+            status = "RESULT CHANGED";
+            fail++;
+        } else if (ratio > 1.0 + slack / 100.0) {
+            status = "SLOWER";
+            fail++;
+        }
+
+        printf("%-6s %2d %10.1f %10.1f %8.2f %12.3e  %s\n", rec.name.c_str(), rec.n, rec.ns, ref->ns,
+               ratio, rec.err, status);
+    }
+
+    // a method dropped from the registry or a size no longer measured
+    for (const PerfRecord &b : base) {
+        if (perf_find(recs, b.name, b.n) == NULL) {
+            printf("%-6s %2d %10s %10.1f %8s %12s  %s\n", b.name.c_str(), b.n, "-", b.ns, "-", "-", "MISSING");
+            fail++;
+        }
+    }
+
+    printf("perf-check: %d failure(s)\n", fail);
+
+    return fail ? 1 : 0;
+}
+
+int PerfCheck::update(const char *path)
+{
+    vector<PerfRecord> recs;
+
+    measure(recs);
+
+    if (!save(path, recs)) {
+        fprintf(stderr, "perf-baseline: cannot write %s\n", path);
+        return 2;
+    }
+
+    printf("perf-baseline: %zu records written to %s\n", recs.size(), path);
+
+    return 0;
+}
@@ -0,0 +1,45 @@
+/*
+ * PerfCheck.h
+ *
+ *  Created on: 2026-10-19 06:01
+ */
+
+#ifndef __PERF_CHECK__
+#define __PERF_CHECK__
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+struct PerfRecord {
+    std::string name;
+    int n;
+    double ns;          // best-of-rounds nanoseconds per solve
+    uint64_t digest;    // FNV-1a over the result bits
+    double err;         // max scaled error on the regular systems
+    double rel;         // median over rounds of ns over the ref run before it
+};
+
+// times every method over a fixed-seed corpus for n = 4 and 6 and compares
+// against a baseline file, relative to a reference kernel timed right before
+// it: slower than the slack, a larger error, any result bit changed or a
+// baseline entry missing from the run is a failure
+class PerfCheck
+{
+private:
+    uint64_t seed;
+    long count;
+
+    void measure(std::vector<PerfRecord> &recs);
+
+    static bool load(const char *path, std::vector<PerfRecord> &recs);
+    static bool save(const char *path, const std::vector<PerfRecord> &recs);
+
+public:
+    PerfCheck(uint64_t seed, long count);
+
+    int check(const char *path, double slack);
+    int update(const char *path);
+};
+
+#endif // __PERF_CHECK__
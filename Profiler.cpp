@@ -0,0 +1,203 @@
+/*
+ * Profiler.cpp
+ *
+ *  Created on: 2026-10-19 05:36
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <ctime>
+#endif
+
+#include "Corpus.h"
+#include "Methods.h"
+#include "Profiler.h"
+
+using namespace std;
+
+static int perf_open(uint32_t type, uint64_t config, int group)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = (group == -1) ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+Profiler::Profiler(void)
+{
+    static const uint32_t types[PROF_COUNTER_NUM] = {
+        PERF_TYPE_HARDWARE,
+        PERF_TYPE_HARDWARE,
+        PERF_TYPE_HARDWARE,
+        PERF_TYPE_HW_CACHE,
+    };
+    static const uint64_t configs[PROF_COUNTER_NUM] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_L1D |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+    };
+
+    perf = true;
+
+    for (int i = 0; i < PROF_COUNTER_NUM; i++) {
+        fd[i] = perf_open(types[i], configs[i], (i == 0) ? -1 : fd[0]);
+
+        if (fd[i] < 0) {
+            perf = false;
+        }
+    }
+
+    if (!perf) {
+        for (int i = 0; i < PROF_COUNTER_NUM; i++) {
+            if (fd[i] >= 0) {
+                close(fd[i]);
+            }
+            fd[i] = -1;
+        }
+    }
+}
+
+Profiler::~Profiler(void)
+{
+    for (int i = 0; i < PROF_COUNTER_NUM; i++) {
+        if (fd[i] >= 0) {
+            close(fd[i]);
+        }
+    }
+}
+
+bool Profiler::has_perf(void) const
+{
+    return perf;
+}
+
+const char *Profiler::counter_name(int idx)
+{
+    static const char *names[PROF_COUNTER_NUM] = {
+        "cycles", "instr", "br-miss", "l1d-miss"
+    };
+
+    return names[idx];
+}
+
+uint64_t Profiler::rdtsc(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+void Profiler::start(void)
+{
+    if (perf) {
+        ioctl(fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    } else {
+        tsc = rdtsc();
+    }
+}
+
+void Profiler::stop(uint64_t val[PROF_COUNTER_NUM])
+{
+    memset(val, 0, sizeof(uint64_t) * PROF_COUNTER_NUM);
+
+    if (perf) {
+        uint64_t buf[1 + PROF_COUNTER_NUM] = { 0 };
+
+        ioctl(fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        if (read(fd[0], buf, sizeof(buf)) > 0) {
+            for (int i = 0; i < PROF_COUNTER_NUM && i < (int)buf[0]; i++) {
+                val[i] = buf[1 + i];
+            }
+        }
+    } else {
+        val[PROF_CYCLES] = rdtsc() - tsc;
+    }
+}
+
+ProfileRun::ProfileRun(uint64_t seed) : seed(seed)
+{
+}
+
+void ProfileRun::run(long count)
+{
+    static const int sizes[] = { 4, 6 };
+
+    EquationSolver *solver = new EquationSolver();
+    Profiler *prof = new Profiler();
+
+    printf("------------------------------- PROFILE ---------------------------------- %s\n",
+           prof->has_perf() ? "perf_event" : "rdtsc");
+
+    for (int n : sizes) {
+        // the corpus is generated up front so only the solves are counted
+        vector<int64_t> coeff(count * 49);
+        Corpus corpus(seed + n);
+
+        for (long c = 0; c < count; c++) {
+            corpus.generate((int64_t (*)[7])&coeff[c * 49], n, c % CORPUS_KIND_NUM);
+        }
+
+        printf("%-6s %2s", "method", "n");
+        if (prof->has_perf()) {
+            for (int i = 0; i < PROF_COUNTER_NUM; i++) {
+                printf("%12s", Profiler::counter_name(i));
+            }
+            printf("%8s\n", "ipc");
+        } else {
+            printf("%12s\n", "tsc");
+        }
+
+        for (int m = 0; m < solver_method_num; m++) {
+            uint64_t val[PROF_COUNTER_NUM];
+            double res[6];
+
+            prof->start();
+            for (long c = 0; c < count; c++) {
+                solver_methods[m].solve(solver, (int64_t (*)[7])&coeff[c * 49], n, res);
+            }
+            prof->stop(val);
+
+            printf("%-6s %2d", solver_methods[m].name, n);
+            if (prof->has_perf()) {
+                for (int i = 0; i < PROF_COUNTER_NUM; i++) {
+                    printf("%12.1f", (double)val[i] / count);
+                }
+                printf("%8.2f\n", val[PROF_CYCLES] ? (double)val[PROF_INSTRUCTIONS] / val[PROF_CYCLES] : 0.0);
+            } else {
+                printf("%12.1f\n", (double)val[PROF_CYCLES] / count);
+            }
+        }
+    }
+
+    delete(prof);
+    delete(solver);
+}
@@ -0,0 +1,54 @@
+/*
+ * Profiler.h
+ *
+ *  Created on: 2026-10-19 05:36
+ */
+
+#ifndef __PROFILER__
+#define __PROFILER__
+
+#include <cstdint>
+
+enum {
+    PROF_CYCLES = 0,
+    PROF_INSTRUCTIONS,
+    PROF_BRANCH_MISSES,
+    PROF_L1D_MISSES,
+    PROF_COUNTER_NUM
+};
+
+// hardware counters via perf_event_open, falls back to rdtsc when the
+// kernel or the sandbox does not allow it
+class Profiler
+{
+private:
+    int fd[PROF_COUNTER_NUM];
+    bool perf = false;
+    uint64_t tsc = 0;
+
+public:
+    Profiler(void);
+    ~Profiler(void);
+
+    bool has_perf(void) const;
+    static const char *counter_name(int idx);
+
+    static uint64_t rdtsc(void);
+
+    void start(void);
+    void stop(uint64_t val[PROF_COUNTER_NUM]);
+};
+
+// runs every method over a fixed corpus and prints per-method, per-n counters
+class ProfileRun
+{
+private:
+    uint64_t seed;
+
+public:
+    ProfileRun(uint64_t seed);
+
+    void run(long count);
+};
+
+#endif // __PROFILER__
@@ -0,0 +1,94 @@
+/*
+ * ReferenceSolver.cpp
+ *
+ *  Created on: 2026-10-19 05:33
+ */
+
+#include "ReferenceSolver.h"
+
+using namespace std;
+
+void ReferenceSolver::load_data(const int64_t i64EqualCoeff[7][7], int iParaNum)
+{
+    for (int row = 0; row < iParaNum; row++) {
+        for (int i = 0; i < iParaNum + 1; i++) {
+            C[row][i] = BigInt(i64EqualCoeff[row + 1][i]);
+        }
+    }
+}
+
+// fraction-free Gauss-Jordan elimination, every division is exact so the
+// entries stay minors of the input and the result is the exact rational
+// x[i] = C[i][n] / C[i][i], with all C[i][i] equal to +/- det
+bool ReferenceSolver::method_bareiss(int n)
+{
+    BigInt P(1);
+
+    zero = false;
+
+    for (int k = 0; k < n; k++) {
+        // any non-zero pivot keeps the divisions exact
+        int m = k;
+
+        while (m < n && C[m][k].is_zero()) {
+            m++;
+        }
+
+        if (m == n) {
+            zero = true;
+            return false;
+        }
+
+        if (m != k) {
+            for (int j = 0; j < n + 1; j++) {
+                swap(C[k][j], C[m][j]);
+            }
+        }
+
+        const BigInt M = C[k][k];
+
+        for (int i = 0; i < n; i++) {
+            if (i == k) {
+                continue;
+            }
+
+            const BigInt L = C[i][k];
+
+            for (int j = 0; j < n + 1; j++) {
+                if (j == k) {
+                    continue;
+                }
+
+                C[i][j] = (M * C[i][j] - L * C[k][j]) / P;
+            }
+
+            C[i][k] = BigInt(0);
+        }
+
+        P = M;
+    }
+
+    return true;
+}
+
+bool ReferenceSolver::is_singular(void) const
+{
+    return zero;
+}
+
+const BigInt &ReferenceSolver::get_num(int i, int n) const
+{
+    return C[i][n];
+}
+
+const BigInt &ReferenceSolver::get_den(int i) const
+{
+    return C[i][i];
+}
+
+void ReferenceSolver::save_data(double dAffinePara[6], int iParaNum)
+{
+    for (int i = 0; i < iParaNum; i++) {
+        dAffinePara[i] = zero ? 0.0 : BigInt::ratio(C[i][iParaNum], C[i][i]);
+    }
+}
@@ -0,0 +1,32 @@
+/*
+ * ReferenceSolver.h
+ *
+ *  Created on: 2026-10-19 05:33
+ */
+
+#ifndef __REFERENCE_SOLVER__
+#define __REFERENCE_SOLVER__
+
+#include "BigInt.h"
+
+// exact solver used as ground truth for the EquationSolver methods
+class ReferenceSolver
+{
+private:
+    bool zero = false;
+    BigInt C[7][7];
+
+public:
+    void load_data(const int64_t i64EqualCoeff[7][7], int iParaNum);
+
+    bool method_bareiss(int n);
+
+    bool is_singular(void) const;
+
+    const BigInt &get_num(int i, int n) const;
+    const BigInt &get_den(int i) const;
+
+    void save_data(double dAffinePara[6], int iParaNum);
+};
+
+#endif // __REFERENCE_SOLVER__
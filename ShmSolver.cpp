@@ -0,0 +1,375 @@
+/*
+ * ShmSolver.cpp
+ *
+ *  Created on: 2026-10-19 06:18
+ */
+
+#include <new>
+#include <chrono>
+#include <thread>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ShmSolver.h"
+
+using namespace std;
+
+// whether the process that created a region still exists
+static bool shm_alive(int32_t pid)
+{
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+// clients, slots and server pid of an existing region, false when it is
+// too short for a header or was not made by this version
+static bool shm_header(int fd, uint32_t *clients, uint32_t *slots, int32_t *owner)
+{
+    struct stat st;
+
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(ShmHeader)) {
+        return false;
+    }
+
+    void *addr = mmap(nullptr, sizeof(ShmHeader), PROT_READ, MAP_SHARED, fd, 0);
+
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+
+    const ShmHeader *h = (const ShmHeader *)addr;
+    bool ok = (h->magic == SHM_MAGIC && h->version == SHM_VERSION);
+
+    *clients = h->clients;
+    *slots = h->slots;
+    *owner = h->owner;
+
+    munmap(addr, sizeof(ShmHeader));
+
+    return ok;
+}
+
+ShmServer::ShmServer(int method, int frac)
+    : method(method), frac(frac), size(0), hdr(nullptr), ring(nullptr)
+{
+    name[0] = '\0';
+}
+
+ShmServer::~ShmServer(void)
+{
+    if (hdr) {
+        munmap(hdr, size);
+        shm_unlink(name);
+    }
+}
+
+bool ShmServer::create(const char *name, int clients, int slots)
+{
+    if (hdr || clients < 1 || clients > SHM_MAX_CLIENTS || slots < 1 || strlen(name) >= sizeof(this->name)) {
+        return false;
+    }
+
+    // a region left behind by a server that died is replaced, one whose
+    // server is still running is not taken over
+    int old = shm_open(name, O_RDONLY, 0);
+
+    if (old >= 0) {
+        uint32_t c, s;
+        int32_t owner;
+        bool live = shm_header(old, &c, &s, &owner) && shm_alive(owner);
+
+        close(old);
+
+        if (live) {
+            return false;
+        }
+
+        shm_unlink(name);
+    }
+
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    size = sizeof(ShmHeader) + sizeof(ShmSlot) * clients * slots;
+
+    if (ftruncate(fd, size) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return false;
+    }
+
+    void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    close(fd);
+
+    if (addr == MAP_FAILED) {
+        shm_unlink(name);
+        return false;
+    }
+
+    // the mapping comes zero-filled, every slot starts out FREE
+    hdr = new (addr) ShmHeader();
+    ring = (ShmSlot *)((char *)addr + sizeof(ShmHeader));
+
+    for (int i = 0; i < clients * slots; i++) {
+        new (&ring[i]) ShmSlot();
+    }
+
+    hdr->version = SHM_VERSION;
+    hdr->clients = clients;
+    hdr->slots = slots;
+    hdr->owner = getpid();
+
+    atomic_thread_fence(memory_order_release);
+
+    hdr->magic = SHM_MAGIC;
+
+    strcpy(this->name, name);
+
+    return true;
+}
+
+// n is the size checked on collection, the slots themselves stay writable by the client
+void ShmServer::solve_batch(BatchSolver *batch, ShmSlot **slot, int num, int n)
+{
+    for (int l = 0; l < num; l++) {
+        batch->load_data(l, slot[l]->i64EqualCoeff, n);
+    }
+
+    if (method == BATCH_DFA) {
+        batch->method_dfa(n);
+    } else {
+        batch->method_gem(n);
+    }
+
+    for (int l = 0; l < num; l++) {
+        if (method == BATCH_DFA) {
+            slot[l]->status = batch->save_data(l, slot[l]->dAffinePara, n, frac);
+        } else {
+            slot[l]->status = batch->save_data_gem(l, slot[l]->dAffinePara, n);
+        }
+
+        slot[l]->state.store(SHM_DONE, memory_order_release);
+    }
+}
+
+void ShmServer::run(void)
+{
+    BatchSolver *batch = new BatchSolver();
+    ShmSlot *pend[7][BATCH_LANES];
+    int num[7] = { 0 };
+    int idle = 0;
+
+    int clients = hdr->clients;
+    int slots = hdr->slots;
+
+    while (!hdr->stop.load(memory_order_acquire)) {
+        bool got = false;
+
+        for (int c = 0; c < clients; c++) {
+            uint32_t pos = hdr->cursor[c].load(memory_order_relaxed);
+
+            // at most one batch per client and sweep, a busy client cannot starve the rest
+            for (int i = 0; i < BATCH_LANES; i++) {
+                ShmSlot *slot = &ring[c * slots + pos % slots];
+
+                if (slot->state.load(memory_order_acquire) != SHM_READY) {
+                    break;
+                }
+
+                // the cursor moves before the slot can turn DONE, a client attaching later relies on it
+                hdr->cursor[c].store(++pos, memory_order_relaxed);
+
+                got = true;
+
+                int n = slot->iParaNum;
+
+                // the record comes from another process, never index with it unchecked
+                if (n < 1 || n > 6) {
+                    memset(slot->dAffinePara, 0x00, sizeof(slot->dAffinePara));
+                    slot->status = SOLVE_INVALID;
+                    slot->state.store(SHM_DONE, memory_order_release);
+                    continue;
+                }
+
+                // group by size, a full group goes out right away
+                pend[n][num[n]++] = slot;
+                if (num[n] == BATCH_LANES) {
+                    solve_batch(batch, pend[n], num[n], n);
+                    num[n] = 0;
+                }
+            }
+        }
+
+        // partial groups go out at the end of every sweep, a lone request
+        // never waits for a busy client to stop submitting
+        for (int n = 1; n < 7; n++) {
+            if (num[n]) {
+                solve_batch(batch, pend[n], num[n], n);
+                num[n] = 0;
+            }
+        }
+
+        if (got) {
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < 64) {
+            this_thread::yield();
+        } else {
+            this_thread::sleep_for(chrono::microseconds(50));
+        }
+    }
+
+    delete(batch);
+}
+
+void ShmServer::halt(void)
+{
+    hdr->stop.store(1, memory_order_release);
+}
+
+ShmClient::ShmClient(void)
+    : size(0), hdr(nullptr), ring(nullptr), id(-1), head(0), tail(0)
+{
+}
+
+ShmClient::~ShmClient(void)
+{
+    if (hdr) {
+        hdr->attached[id].store(0, memory_order_release);
+        munmap(hdr, size);
+    }
+}
+
+bool ShmClient::open(const char *name)
+{
+    if (hdr) {
+        return false;
+    }
+
+    int fd = shm_open(name, O_RDWR, 0);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    uint32_t clients, slots;
+    int32_t owner;
+
+    // only a region whose server is running can answer
+    if (!shm_header(fd, &clients, &slots, &owner) || !shm_alive(owner)) {
+        close(fd);
+        return false;
+    }
+
+    size = sizeof(ShmHeader) + sizeof(ShmSlot) * clients * slots;
+
+    void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    close(fd);
+
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+
+    ShmHeader *h = (ShmHeader *)addr;
+
+    // claim a free client ring
+    for (uint32_t c = 0; c < clients; c++) {
+        uint32_t zero = 0;
+
+        if (h->attached[c].compare_exchange_strong(zero, 1, memory_order_acq_rel)) {
+            id = c;
+            break;
+        }
+    }
+
+    if (id < 0) {
+        munmap(addr, size);
+        return false;
+    }
+
+    hdr = h;
+    ring = (ShmSlot *)((char *)addr + sizeof(ShmHeader)) + id * slots;
+
+    // a previous owner may have left requests behind, let the server answer
+    // them before the ring is reset, the cursor is final once nothing is READY;
+    // a server that died meanwhile never will, the ring is given up
+    for (uint32_t i = 0; i < slots; i++) {
+        while (ring[i].state.load(memory_order_acquire) == SHM_READY && !hdr->stop.load(memory_order_relaxed)) {
+            if (!shm_alive(hdr->owner)) {
+                hdr->attached[id].store(0, memory_order_release);
+                munmap(addr, size);
+                hdr = nullptr;
+                ring = nullptr;
+                id = -1;
+                return false;
+            }
+
+            this_thread::yield();
+        }
+
+        ring[i].state.store(SHM_FREE, memory_order_relaxed);
+    }
+
+    head = tail = hdr->cursor[id].load(memory_order_acquire);
+
+    return true;
+}
+
+int64_t (*ShmClient::acquire(void))[7]
+{
+    ShmSlot *slot = &ring[head % hdr->slots];
+
+    if (slot->state.load(memory_order_acquire) != SHM_FREE) {
+        return nullptr;
+    }
+
+    return slot->i64EqualCoeff;
+}
+
+// publishes the slot acquire() handed out
+void ShmClient::submit(int iParaNum, uint64_t tag)
+{
+    ShmSlot *slot = &ring[head++ % hdr->slots];
+
+    slot->iParaNum = iParaNum;
+    slot->tag = tag;
+    slot->state.store(SHM_READY, memory_order_release);
+}
+
+const ShmSlot *ShmClient::poll(void)
+{
+    if (tail == head) {
+        return nullptr;
+    }
+
+    ShmSlot *slot = &ring[tail % hdr->slots];
+
+    if (slot->state.load(memory_order_acquire) != SHM_DONE) {
+        return nullptr;
+    }
+
+    return slot;
+}
+
+// hands the slot poll() returned back for reuse
+void ShmClient::release(void)
+{
+    ring[tail++ % hdr->slots].state.store(SHM_FREE, memory_order_release);
+}
+
+void ShmClient::halt(void)
+{
+    hdr->stop.store(1, memory_order_release);
+}
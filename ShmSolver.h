@@ -0,0 +1,106 @@
+/*
+ * ShmSolver.h
+ *
+ *  Created on: 2026-10-19 06:18
+ */
+
+#ifndef __SHM_SOLVER__
+#define __SHM_SOLVER__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "BatchSolver.h"
+
+#define SHM_MAGIC       0x53514553  // "SEQS"
+#define SHM_VERSION     2
+#define SHM_MAX_CLIENTS 16
+
+// slot states, a slot only moves forward through them: the client owns a
+// FREE slot, the server a READY one, and the client again a DONE one
+enum {
+    SHM_FREE = 0,
+    SHM_READY,
+    SHM_DONE,
+};
+
+// one fixed-size record, the client writes the coefficients in place and
+// the server writes the parameters back into the same slot
+struct alignas(64) ShmSlot {
+    std::atomic<uint32_t> state;
+    int32_t iParaNum;
+    int32_t status;
+    uint64_t tag;
+    int64_t i64EqualCoeff[7][7];
+    double dAffinePara[6];
+};
+
+// start of the mapping, followed by clients * slots ShmSlot records; every
+// client owns a ring of its own, cursor is the next slot the server looks at
+// and owner the pid of the serving process
+struct alignas(64) ShmHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t clients;
+    uint32_t slots;
+    int32_t owner;
+    std::atomic<uint32_t> stop;
+    std::atomic<uint32_t> attached[SHM_MAX_CLIENTS];
+    std::atomic<uint32_t> cursor[SHM_MAX_CLIENTS];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "process-shared atomics must be lock-free");
+
+// owns the POSIX shared-memory region, sweeps every client ring and solves
+// what is READY in BATCH_LANES sized groups through BatchSolver, straight
+// out of and back into the slots
+class ShmServer
+{
+private:
+    int method;
+    int frac;
+    char name[64];
+    size_t size;
+    ShmHeader *hdr;
+    ShmSlot *ring;
+
+    void solve_batch(BatchSolver *batch, ShmSlot **slot, int num, int n);
+
+public:
+    ShmServer(int method, int frac = 8);
+    ~ShmServer(void);
+
+    bool create(const char *name, int clients, int slots);
+    void run(void);
+    void halt(void);
+};
+
+// attaches to a running server and claims one client ring; acquire() hands
+// out the coefficients of the next free slot, poll() the oldest answered one
+class ShmClient
+{
+private:
+    size_t size;
+    ShmHeader *hdr;
+    ShmSlot *ring;
+    int id;
+    uint32_t head;
+    uint32_t tail;
+
+public:
+    ShmClient(void);
+    ~ShmClient(void);
+
+    bool open(const char *name);
+
+    int64_t (*acquire(void))[7];
+    void submit(int iParaNum, uint64_t tag);
+
+    const ShmSlot *poll(void);
+    void release(void);
+
+    void halt(void);
+};
+
+#endif // __SHM_SOLVER__
@@ -0,0 +1,111 @@
+/*
+ * SolveRing.h
+ *
+ *  Created on: 2026-10-19 05:43
+ */
+
+#ifndef __SOLVE_RING__
+#define __SOLVE_RING__
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+// bounded lock-free multi-producer multi-consumer ring, every cell carries
+// a sequence number so push and pop never wait on each other
+template <typename T>
+class SolveRing
+{
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        T data;
+    };
+
+    size_t mask;
+    std::unique_ptr<Cell[]> cells;
+
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+
+public:
+    SolveRing(size_t capacity)
+    {
+        size_t size = 2;
+
+        while (size < capacity) {
+            size <<= 1;
+        }
+
+        mask = size - 1;
+        cells.reset(new Cell[size]);
+
+        for (size_t i = 0; i < size; i++) {
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+
+    // returns false instead of blocking when the ring is full
+    bool push(const T &val)
+    {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Cell *cell = nullptr;
+
+        for (;;) {
+            cell = &cells[pos & mask];
+
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+
+            if (dif == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false;
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = val;
+        cell->seq.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // returns false when the ring is empty
+    bool pop(T &val)
+    {
+        size_t pos = head.load(std::memory_order_relaxed);
+        Cell *cell = nullptr;
+
+        for (;;) {
+            cell = &cells[pos & mask];
+
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+
+            if (dif == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false;
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+
+        val = cell->data;
+        cell->seq.store(pos + mask + 1, std::memory_order_release);
+
+        return true;
+    }
+};
+
+#endif // __SOLVE_RING__
@@ -0,0 +1,22 @@
+/*
+ * SolverKernel.h
+ *
+ *  Created on: 2026-10-19 06:51
+ */
+
+#ifndef __SOLVER_KERNEL__
+#define __SOLVER_KERNEL__
+
+// release builds clone the kernels per ISA level and pick one at load time;
+// the clones of one function are local to the unit that defines it, so a
+// cloned function never has a declaration in a header: each unit keeps its
+// clones in a file-local struct and the public members call through it
+#if defined(SOLVER_CLONES) && defined(__x86_64__) && defined(__GNUC__)
+#define SOLVER_KERNEL __attribute__((target_clones("default", "arch=x86-64-v2", "arch=x86-64-v3", "arch=x86-64-v4")))
+#define SOLVER_INLINE __attribute__((always_inline)) inline
+#else
+#define SOLVER_KERNEL
+#define SOLVER_INLINE inline
+#endif
+
+#endif // __SOLVER_KERNEL__
@@ -0,0 +1,100 @@
+/*
+ * Tracer.cpp
+ *
+ *  Created on: 2026-10-19 06:14
+ */
+
+#include <cstring>
+
+#include "Tracer.h"
+
+using namespace std;
+
+struct TraceHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    uint32_t count;
+};
+
+TraceRing::TraceRing(void) : ring(TRACE_RING_SIZE)
+{
+}
+
+TraceRecord *TraceRing::next(void)
+{
+    return &ring[head++ % TRACE_RING_SIZE];
+}
+
+size_t TraceRing::size(void) const
+{
+    return (head < TRACE_RING_SIZE) ? head : TRACE_RING_SIZE;
+}
+
+void TraceRing::clear(void)
+{
+    head = 0;
+}
+
+// oldest record first
+bool TraceRing::dump(FILE *fp) const
+{
+    TraceHeader hdr = { TRACE_MAGIC, TRACE_VERSION, sizeof(TraceRecord), (uint32_t)size() };
+
+    if (fwrite(&hdr, sizeof(hdr), 1, fp) != 1) {
+        return false;
+    }
+
+    for (uint64_t i = head - size(); i < head; i++) {
+        if (fwrite(&ring[i % TRACE_RING_SIZE], sizeof(TraceRecord), 1, fp) != 1) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TraceRing::read(FILE *fp, vector<TraceRecord> &recs)
+{
+    TraceHeader hdr;
+
+    if (fread(&hdr, sizeof(hdr), 1, fp) != 1) {
+        return false;
+    }
+
+    // dump never writes more than one ring
+    if (hdr.magic != TRACE_MAGIC || hdr.version != TRACE_VERSION || hdr.size != sizeof(TraceRecord) ||
+        hdr.count > TRACE_RING_SIZE) {
+        return false;
+    }
+
+    recs.resize(hdr.count);
+
+    if (fread(recs.data(), sizeof(TraceRecord), hdr.count, fp) != hdr.count) {
+        return false;
+    }
+
+    for (const TraceRecord &rec : recs) {
+        if (!valid(rec)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// a record from a file indexes the matrix and shift arrays when rendered,
+// every field must be one that trace_mat can have written
+bool TraceRing::valid(const TraceRecord &rec)
+{
+    return rec.type <= TRACE_RESULT && rec.fmt <= TRACE_F32 &&
+           rec.n >= 1 && rec.n <= 6 && rec.k < rec.n && rec.m < rec.n &&
+           rec.shifts <= sizeof(rec.shift) && memchr(rec.name, 0, sizeof(rec.name)) != NULL;
+}
+
+TraceRing &TraceRing::local(void)
+{
+    static thread_local TraceRing ring;
+
+    return ring;
+}
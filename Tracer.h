@@ -0,0 +1,73 @@
+/*
+ * Tracer.h
+ *
+ *  Created on: 2026-10-19 06:14
+ */
+
+#ifndef __TRACER__
+#define __TRACER__
+
+#include <cstdio>
+#include <vector>
+#include <cstdint>
+
+#define TRACE_RING_SIZE   4096
+#define TRACE_MAGIC       0x52545145    // "EQTR"
+#define TRACE_VERSION     1
+
+enum {
+    TRACE_BEGIN = 0,    // input matrix, name holds the method label
+    TRACE_STEP,         // matrix after elimination step k
+    TRACE_SWAP_A,       // before swapping rows k and m
+    TRACE_SWAP_B,       // after swapping rows k and m
+    TRACE_RESULT,       // matrix handed to save_data
+};
+
+enum {
+    TRACE_I64 = 0,
+    TRACE_F64,
+    TRACE_F32,
+};
+
+// fixed-size binary record, one per print_mat call of a sampled solve
+struct TraceRecord {
+    uint64_t seq;
+    uint8_t type;
+    uint8_t fmt;
+    uint8_t n;
+    uint8_t k;
+    uint8_t m;
+    uint8_t shifts;
+    char name[6];
+    uint8_t shift[48];  // scale_mat shifts of the step, in call order
+    union {
+        int64_t i[7][7];
+        double d[7][7];
+        float f[7][7];
+    } T;
+};
+
+// per-thread ring of the most recent records, allocated once and then
+// overwritten oldest first
+class TraceRing
+{
+private:
+    std::vector<TraceRecord> ring;
+    uint64_t head = 0;
+
+public:
+    TraceRing(void);
+
+    TraceRecord *next(void);
+
+    size_t size(void) const;
+    void clear(void);
+
+    bool dump(FILE *fp) const;
+    static bool read(FILE *fp, std::vector<TraceRecord> &recs);
+    static bool valid(const TraceRecord &rec);
+
+    static TraceRing &local(void);
+};
+
+#endif // __TRACER__
@@ -5,7 +5,27 @@
  *      Author: Jack Chen <redchenjs@live.com>
  */
 
+#include <cstdlib>
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <chrono>
+#include <vector>
+
+#include "Corpus.h"
+#include "DiffTest.h"
+#include "CoSolver.h"
+#include "AsyncSolver.h"
+#include "ShmSolver.h"
+#include "Methods.h"
+#include "Profiler.h"
+#include "PerfCheck.h"
+#include "Tracer.h"
+#include "LatencyHist.h"
 #include "EquationSolver.h"
+#include "EquationSolverCore.h"
+#include "EquationSolverInline.h"
 
 /*
  2  -3   1   5   6
@@ -43,7 +63,7 @@
  x3 =   0.8
 */
 
-static const int64_t C[7][7] = {
+static constexpr int64_t C[7][7] = {
     [0] = { 0,   0,   0,   0,   0,   0,   0},
     [1] = { 0,   1,   2,   2,   1,   0,   0},
     [2] = { 1,   1,   1,   1,   0,   0,   0},
@@ -65,10 +85,556 @@ static const int64_t C[7][7] = {
 };
 */
 
+// solved at compile time
+static constexpr CoreResult R = core_solve<int64_t>(C, 4);
+
+static_assert(!R.zero, "unexpected singular system");
+static_assert(R.x[0] == -2.0 && R.x[1] == 3.0 && R.x[2] == -1.0 && R.x[3] == 0.0, "wrong solution");
+
+static constexpr CoreResult RF = core_solve<double>(C, 4);
+
+static_assert(core_abs(RF.x[0] + 2.0) < 1e-12 && core_abs(RF.x[1] - 3.0) < 1e-12 &&
+              core_abs(RF.x[2] + 1.0) < 1e-12 && core_abs(RF.x[3] - 0.0) < 1e-12, "wrong solution");
+
+// the realistic system outgrows int64 minors and finishes in double
+static constexpr int64_t CW[7][7] = {
+    [0] = { 0,   0,   0,   0,   0,   0,   0},
+    [1] = {  22011332,   387232848,   5219810,    121208776,   62134656,   0,   0},
+    [2] = { 387232848, 13023152016,  507249608, -4173773200, 1455695872,   0,   0},
+    [3] = {   5219810,   507249608,   48421896,  -575676040,    7083392,   0,   0},
+    [4] = { 121208776, -4173773200, -575676040, 12016008592, 2715599360,   0,   0},
+    [5] = { 0,   0,   0,   0,   0,   0,   0},
+    [6] = { 0,   0,   0,   0,   0,   0,   0},
+};
+
+static constexpr CoreResult RW = core_solve<int64_t>(CW, 4);
+
+static_assert(RW.wide && !RW.zero, "overflow must not read as singular");
+static_assert(core_abs(RW.x[0] + 10.739089246) < 1e-6 && core_abs(RW.x[1] - 0.460195081) < 1e-6 &&
+              core_abs(RW.x[2] - 5.478937449) < 1e-6 && core_abs(RW.x[3] - 0.756666747) < 1e-6, "wrong solution");
+
 static double D[6] = { 0.0 };
 
+static int run_verify(int argc, char **argv)
+{
+    long count = (argc > 2) ? atol(argv[2]) : 10000;
+    uint64_t seed = (argc > 3) ? strtoull(argv[3], NULL, 0) : 1;
+
+    DiffTest *test = new DiffTest(seed);
+
+    test->run(count);
+
+    delete(test);
+
+    return 0;
+}
+
+// the corpus seed and size are fixed so the baseline stays comparable
+static int run_perf_check(int argc, char **argv)
+{
+    const char *path = (argc > 2) ? argv[2] : "perf/baseline.txt";
+    double slack = (argc > 3) ? atof(argv[3]) : 25.0;
+
+    PerfCheck *check = new PerfCheck(1, 5000);
+
+    int ret = check->check(path, slack);
+
+    delete(check);
+
+    return ret;
+}
+
+static int run_perf_baseline(int argc, char **argv)
+{
+    const char *path = (argc > 2) ? argv[2] : "perf/baseline.txt";
+
+    PerfCheck *check = new PerfCheck(1, 5000);
+
+    int ret = check->update(path);
+
+    delete(check);
+
+    return ret;
+}
+
+// every registry method over the corpus with 1-in-every solves traced,
+// the thread's ring is written to file for trace-decode
+static int run_trace(int argc, char **argv)
+{
+    long count = (argc > 2) ? atol(argv[2]) : 1000;
+    int every = (argc > 3) ? atoi(argv[3]) : 100;
+    const char *path = (argc > 4) ? argv[4] : "trace.bin";
+
+    std::vector<int64_t> coeff(count * 49);
+    Corpus corpus(1);
+
+    for (long c = 0; c < count; c++) {
+        corpus.generate((int64_t (*)[7])&coeff[c * 49], (c & 1) ? 6 : 4, c % CORPUS_KIND_NUM);
+    }
+
+    EquationSolver *solver = new EquationSolver();
+    std::vector<double> ns(solver_method_num * 2, HUGE_VAL);
+
+    // interleaved rounds per method in alternating order, the best of each
+    // side, as in latency
+    for (int round = 0; round < 20; round++) {
+        for (int m = 0; m < solver_method_num; m++) {
+            for (int p = 0; p < 2; p++) {
+                int pass = p ^ (round & 1);
+                auto start = std::chrono::steady_clock::now();
+
+                solver->set_trace(pass ? every : 0);
+
+                for (long c = 0; c < count; c++) {
+                    double res[6];
+
+                    solver_methods[m].solve(solver, (int64_t (*)[7])&coeff[c * 49], (c & 1) ? 6 : 4, res);
+                }
+
+                double t = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+                ns[m * 2 + pass] = std::min(ns[m * 2 + pass], t);
+            }
+        }
+    }
+
+    delete(solver);
+
+    double off = 0.0, on = 0.0;
+
+    for (int m = 0; m < solver_method_num; m++) {
+        off += ns[m * 2];
+        on += ns[m * 2 + 1];
+    }
+
+    FILE *fp = fopen(path, "wb");
+    bool ok = (fp != NULL) && TraceRing::local().dump(fp);
+
+    if (fp != NULL) {
+        fclose(fp);
+    }
+
+    if (!ok) {
+        fprintf(stderr, "trace: cannot write %s\n", path);
+        return 2;
+    }
+
+    printf("1 in %d solves traced, %zu records written to %s, %.1f%% slower than untraced\n",
+           every, TraceRing::local().size(), path, (on / off - 1.0) * 100.0);
+
+    return 0;
+}
+
+static int run_trace_decode(int argc, char **argv)
+{
+    const char *path = (argc > 2) ? argv[2] : "trace.bin";
+    std::vector<TraceRecord> recs;
+
+    FILE *fp = fopen(path, "rb");
+    bool ok = (fp != NULL) && TraceRing::read(fp, recs);
+
+    if (fp != NULL) {
+        fclose(fp);
+    }
+
+    if (!ok) {
+        fprintf(stderr, "trace-decode: cannot read %s\n", path);
+        return 2;
+    }
+
+    EquationSolver *solver = new EquationSolver();
+
+    for (const TraceRecord &rec : recs) {
+        solver->print_trace(rec);
+    }
+
+    delete(solver);
+
+    return 0;
+}
+
+// every registry method over the corpus with the latency histograms off
+// and on; the table is printed by the exit handler
+static int run_latency(int argc, char **argv)
+{
+    long count = (argc > 2) ? atol(argv[2]) : 20000;
+
+    std::vector<int64_t> coeff(count * 49);
+    Corpus corpus(1);
+
+    for (long c = 0; c < count; c++) {
+        corpus.generate((int64_t (*)[7])&coeff[c * 49], (c & 1) ? 6 : 4, c % CORPUS_KIND_NUM);
+    }
+
+    LatencyHist::dump_at_exit(stdout);
+
+    EquationSolver *solver = new EquationSolver();
+    std::vector<double> ns(solver_method_num * 2, HUGE_VAL);
+
+    // interleaved rounds per method, the best of each side, so a slow
+    // stretch of the machine cannot land on one side of the comparison;
+    // the order alternates so neither side always runs warm
+    for (int round = 0; round < 20; round++) {
+        for (int m = 0; m < solver_method_num; m++) {
+            for (int p = 0; p < 2; p++) {
+                int pass = p ^ (round & 1);
+                auto start = std::chrono::steady_clock::now();
+
+                solver->set_latency(pass != 0);
+
+                for (long c = 0; c < count; c++) {
+                    double res[6];
+
+                    solver_methods[m].solve(solver, (int64_t (*)[7])&coeff[c * 49], (c & 1) ? 6 : 4, res);
+                }
+
+                double t = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+                ns[m * 2 + pass] = std::min(ns[m * 2 + pass], t);
+            }
+        }
+    }
+
+    double off = 0.0, on = 0.0;
+
+    for (int m = 0; m < solver_method_num; m++) {
+        off += ns[m * 2];
+        on += ns[m * 2 + 1];
+    }
+
+    printf("latency histograms on: %.1f%% slower than off, %.1f ns per solve\n",
+           (on / off - 1.0) * 100.0, (on - off) / ((double)solver_method_num * count));
+
+    delete(solver);
+
+    return 0;
+}
+
+static int run_profile(int argc, char **argv)
+{
+    long count = (argc > 2) ? atol(argv[2]) : 100000;
+    uint64_t seed = (argc > 3) ? strtoull(argv[3], NULL, 0) : 1;
+
+    ProfileRun *run = new ProfileRun(seed);
+
+    run->run(count);
+
+    delete(run);
+
+    return 0;
+}
+
+static int run_async(int argc, char **argv)
+{
+    long count = (argc > 2) ? atol(argv[2]) : 100000;
+    int threads = (argc > 3) ? atoi(argv[3]) : 1;
+
+    std::vector<int64_t> coeff(count * 49);
+    Corpus corpus(1);
+
+    for (long c = 0; c < count; c++) {
+        corpus.generate((int64_t (*)[7])&coeff[c * 49], (c & 1) ? 6 : 4, c % CORPUS_KIND_NUM);
+    }
+
+    AsyncSolver *solver = new AsyncSolver(BATCH_GEM, threads, 4096);
+
+    long sent = 0, done = 0, full = 0, diff = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    while (done < count) {
+        // the producer never blocks, a full ring is just counted
+        if (sent < count) {
+            if (solver->submit((int64_t (*)[7])&coeff[sent * 49], (sent & 1) ? 6 : 4, sent)) {
+                sent++;
+            } else {
+                full++;
+            }
+        }
+
+        SolveResult res;
+
+        while (solver->poll(res)) {
+            double ref[6];
+            int n = (res.tag & 1) ? 6 : 4;
+
+            if (n == 6) {
+                inline_gem<6>((int64_t (*)[7])&coeff[res.tag * 49], ref);
+            } else {
+                inline_gem<4>((int64_t (*)[7])&coeff[res.tag * 49], ref);
+            }
+
+            if (memcmp(ref, res.dAffinePara, sizeof(double) * n)) {
+                diff++;
+            }
+
+            done++;
+        }
+    }
+
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    printf("solved %ld systems on %d workers in %.0f us, %.1f ns/solve, %ld ring-full retries, %ld mismatches\n",
+           count, threads, us, us * 1000.0 / count, full, diff);
+
+    delete(solver);
+
+    return diff ? 1 : 0;
+}
+
+#define SHM_NAME "/EquationSolver"
+
+// writes every system straight into a ring slot and checks the answer
+// against inline_gem while the coefficients are still in the slot
+static long run_shm_client(ShmClient *client, long count, int seed)
+{
+    Corpus corpus(seed);
+    long sent = 0, done = 0, diff = 0;
+
+    while (done < count) {
+        int64_t (*coeff)[7];
+
+        if (sent < count && (coeff = client->acquire()) != nullptr) {
+            corpus.generate(coeff, (sent & 1) ? 6 : 4, sent % CORPUS_KIND_NUM);
+            client->submit((sent & 1) ? 6 : 4, sent);
+            sent++;
+            continue;
+        }
+
+        const ShmSlot *slot;
+
+        while ((slot = client->poll()) != nullptr) {
+            double ref[6];
+            int n = slot->iParaNum;
+
+            if (n == 6) {
+                inline_gem<6>(slot->i64EqualCoeff, ref);
+            } else {
+                inline_gem<4>(slot->i64EqualCoeff, ref);
+            }
+
+            if (memcmp(ref, slot->dAffinePara, sizeof(double) * n)) {
+                diff++;
+            }
+
+            client->release();
+            done++;
+        }
+
+        // ring full and nothing answered yet, leave the core to the server
+        std::this_thread::yield();
+    }
+
+    return diff;
+}
+
+static int run_shm(int argc, char **argv)
+{
+    long count = (argc > 2) ? atol(argv[2]) : 100000;
+    int procs = (argc > 3) ? atoi(argv[3]) : 2;
+
+    ShmServer *server = new ShmServer(BATCH_GEM);
+
+    if (!server->create(SHM_NAME, procs, 256)) {
+        fprintf(stderr, "shm: cannot create %s\n", SHM_NAME);
+        delete(server);
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // every client is a process of its own, they share nothing but the region
+    for (int p = 0; p < procs; p++) {
+        if (fork() == 0) {
+            ShmClient *client = new ShmClient();
+
+            if (!client->open(SHM_NAME)) {
+                _exit(2);
+            }
+
+            long diff = run_shm_client(client, count, p + 1);
+
+            delete(client);
+
+            _exit(diff ? 1 : 0);
+        }
+    }
+
+    std::thread worker(&ShmServer::run, server);
+
+    int fail = 0;
+
+    for (int p = 0; p < procs; p++) {
+        int status = 0;
+
+        wait(&status);
+
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fail++;
+        }
+    }
+
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    server->halt();
+    worker.join();
+
+    printf("solved %ld systems from %d processes in %.0f us, %.1f ns/solve, %d failed clients\n",
+           count * procs, procs, us, us * 1000.0 / (count * procs), fail);
+
+    delete(server);
+
+    return fail ? 1 : 0;
+}
+
+static int run_shm_server(int argc, char **argv)
+{
+    const char *name = (argc > 2) ? argv[2] : SHM_NAME;
+    int clients = (argc > 3) ? atoi(argv[3]) : 4;
+
+    ShmServer *server = new ShmServer(BATCH_GEM);
+
+    if (!server->create(name, clients, 256)) {
+        fprintf(stderr, "shm-server: cannot create %s\n", name);
+        delete(server);
+        return 1;
+    }
+
+    // returns once a client calls halt()
+    server->run();
+
+    delete(server);
+
+    return 0;
+}
+
+static int run_shm_client_cmd(int argc, char **argv)
+{
+    const char *name = (argc > 2) ? argv[2] : SHM_NAME;
+    long count = (argc > 3) ? atol(argv[3]) : 100000;
+
+    ShmClient *client = new ShmClient();
+
+    if (!client->open(name)) {
+        fprintf(stderr, "shm-client: cannot attach to %s\n", name);
+        delete(client);
+        return 1;
+    }
+
+    if (count == 0) {
+        client->halt();
+        delete(client);
+        return 0;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    long diff = run_shm_client(client, count, 1);
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    printf("solved %ld systems in %.0f us, %.1f ns/solve, %ld mismatches\n",
+           count, us, us * 1000.0 / count, diff);
+
+    delete(client);
+
+    return diff ? 1 : 0;
+}
+
+static CoTask run_co_one(CoSolver *solver, const int64_t (*coeff)[7], int n, long *diff)
+{
+    double ref[6];
+    CoSolveResult res = co_await solver->solve(coeff, n);
+
+    if (n == 6) {
+        inline_gem<6>(coeff, ref);
+    } else {
+        inline_gem<4>(coeff, ref);
+    }
+
+    if (memcmp(ref, res.dAffinePara, sizeof(double) * n)) {
+        (*diff)++;
+    }
+}
+
+static int run_co(int argc, char **argv)
+{
+    long count = (argc > 2) ? atol(argv[2]) : 100000;
+
+    std::vector<int64_t> coeff(count * 49);
+    Corpus corpus(1);
+
+    for (long c = 0; c < count; c++) {
+        corpus.generate((int64_t (*)[7])&coeff[c * 49], (c & 1) ? 6 : 4, c % CORPUS_KIND_NUM);
+    }
+
+    CoSolver *solver = new CoSolver(BATCH_GEM);
+    long diff = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (long c = 0; c < count; c++) {
+        run_co_one(solver, (int64_t (*)[7])&coeff[c * 49], (c & 1) ? 6 : 4, &diff);
+    }
+
+    solver->flush();
+
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    printf("solved %ld systems from coroutines in %.0f us, %.1f ns/solve, %ld mismatches\n",
+           count, us, us * 1000.0 / count, diff);
+
+    delete(solver);
+
+    return diff ? 1 : 0;
+}
+
 int main(int argc, char **argv)
 {
+    if (argc > 1 && strcmp(argv[1], "verify") == 0) {
+        return run_verify(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "profile") == 0) {
+        return run_profile(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "perf-check") == 0) {
+        return run_perf_check(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "perf-baseline") == 0) {
+        return run_perf_baseline(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "trace") == 0) {
+        return run_trace(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "trace-decode") == 0) {
+        return run_trace_decode(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "latency") == 0) {
+        return run_latency(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "async") == 0) {
+        return run_async(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "shm") == 0) {
+        return run_shm(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "shm-server") == 0) {
+        return run_shm_server(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "shm-client") == 0) {
+        return run_shm_client_cmd(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "co") == 0) {
+        return run_co(argc, argv);
+    }
+
     EquationSolver *solver = new EquationSolver();
 
     solver->set_debug(true);
@@ -118,6 +684,11 @@ int main(int argc, char **argv)
     solver->save_data(D, 4, 8);
     solver->print_data(D, 4);
 
+    solver->load_data(C, 4);
+    solver->method_bfa(4);
+    solver->save_data(D, 4);
+    solver->print_data(D, 4);
+
     delete(solver);
 
     return 0;